@@ -27,7 +27,7 @@
  * @{
  */
 
-#define LTO_API_VERSION 4
+#define LTO_API_VERSION 5
 
 typedef enum {
     LTO_SYMBOL_ALIGNMENT_MASK              = 0x0000001F, /* log2 of alignment */
@@ -236,6 +236,15 @@ extern void
 lto_codegen_set_cpu(lto_code_gen_t cg, const char *cpu);
 
 
+/**
+ * Sets a directory in which to cache generated object files.  If the merged
+ * modules and code generation options match a previous compile, its object
+ * file is reused instead of being regenerated.  Pass NULL to disable caching.
+ */
+extern void
+lto_codegen_set_cache_dir(lto_code_gen_t cg, const char *dir);
+
+
 /**
  * Sets the location of the assembler tool to run. If not set, libLTO
  * will use gcc to invoke the assembler.
@@ -57,19 +57,19 @@ public:
   }
 
   const Statistic &operator++() {
-    // FIXME: This function and all those that follow carefully use an
-    // atomic operation to update the value safely in the presence of
-    // concurrent accesses, but not to read the return value, so the
-    // return value is not thread safe.
+    // FIXME: This function and the other compound operators that return the
+    // statistic itself carefully use an atomic operation to update the value
+    // safely in the presence of concurrent accesses, but not to read the
+    // return value, so the return value is not thread safe.
     sys::AtomicIncrement(&Value);
     return init();
   }
 
   unsigned operator++(int) {
     init();
-    unsigned OldValue = Value;
-    sys::AtomicIncrement(&Value);
-    return OldValue;
+    // Derive the old value from the atomic result rather than re-reading
+    // Value, which another thread may have bumped in the meantime.
+    return sys::AtomicIncrement(&Value) - 1;
   }
 
   const Statistic &operator--() {
@@ -79,9 +79,7 @@ public:
 
   unsigned operator--(int) {
     init();
-    unsigned OldValue = Value;
-    sys::AtomicDecrement(&Value);
-    return OldValue;
+    return sys::AtomicDecrement(&Value) + 1;
   }
 
   const Statistic &operator+=(const unsigned &V) {
@@ -248,15 +248,24 @@ namespace PBQP {
       if (xnItr == g.getEdgeNode1(eItr)) {
         Graph::NodeItr ynItr = g.getEdgeNode2(eItr);
         Vector &yCosts = g.getNodeCosts(ynItr);
-        for (unsigned j = 0; j < yCosts.getLength(); ++j) {
-          PBQPNum min = eCosts[0][j] + xCosts[0];
-          for (unsigned i = 1; i < xCosts.getLength(); ++i) {
-            PBQPNum c = eCosts[i][j] + xCosts[i];
-            if (c < min)
-              min = c;
+        unsigned yLen = yCosts.getLength();
+        // Take the column minima a row at a time, so that the inner loop
+        // walks the row-major cost matrix contiguously instead of striding
+        // down its columns.
+        Vector mins(yLen);
+        const PBQPNum *row = eCosts[0];
+        for (unsigned j = 0; j < yLen; ++j)
+          mins[j] = row[j] + xCosts[0];
+        for (unsigned i = 1; i < xCosts.getLength(); ++i) {
+          row = eCosts[i];
+          PBQPNum xCost = xCosts[i];
+          for (unsigned j = 0; j < yLen; ++j) {
+            PBQPNum c = row[j] + xCost;
+            if (c < mins[j])
+              mins[j] = c;
           }
-          yCosts[j] += min;
         }
+        yCosts += mins;
         h.handleRemoveEdge(eItr, ynItr);
      } else {
         Graph::NodeItr ynItr = g.getEdgeNode1(eItr);
@@ -311,19 +320,30 @@ namespace PBQP {
       unsigned xLen = xCosts.getLength(),
                yLen = yxeCosts->getRows(),
                zLen = zxeCosts->getRows();
-               
-      Matrix delta(yLen, zLen);
+
+      // If y and z are already connected the other way around, build delta
+      // in that orientation rather than transposing it afterwards.
+      Graph::EdgeItr yzeItr = g.findEdge(ynItr, znItr);
+      bool flipDelta = yzeItr != g.edgesEnd() &&
+                       ynItr != g.getEdgeNode1(yzeItr);
+
+      Matrix delta(flipDelta ? zLen : yLen, flipDelta ? yLen : zLen);
 
       for (unsigned i = 0; i < yLen; ++i) {
+        const PBQPNum *yRow = (*yxeCosts)[i];
         for (unsigned j = 0; j < zLen; ++j) {
-          PBQPNum min = (*yxeCosts)[i][0] + (*zxeCosts)[j][0] + xCosts[0];
+          const PBQPNum *zRow = (*zxeCosts)[j];
+          PBQPNum min = yRow[0] + zRow[0] + xCosts[0];
           for (unsigned k = 1; k < xLen; ++k) {
-            PBQPNum c = (*yxeCosts)[i][k] + (*zxeCosts)[j][k] + xCosts[k];
+            PBQPNum c = yRow[k] + zRow[k] + xCosts[k];
             if (c < min) {
               min = c;
             }
           }
-          delta[i][j] = min;
+          if (flipDelta)
+            delta[j][i] = min;
+          else
+            delta[i][j] = min;
         }
       }
 
@@ -333,20 +353,14 @@ namespace PBQP {
       if (flipEdge2)
         delete zxeCosts;
 
-      Graph::EdgeItr yzeItr = g.findEdge(ynItr, znItr);
       bool addedEdge = false;
 
       if (yzeItr == g.edgesEnd()) {
         yzeItr = g.addEdge(ynItr, znItr, delta);
         addedEdge = true;
       } else {
-        Matrix &yzeCosts = g.getEdgeCosts(yzeItr);
         h.preUpdateEdgeCosts(yzeItr);
-        if (ynItr == g.getEdgeNode1(yzeItr)) {
-          yzeCosts += delta;
-        } else {
-          yzeCosts += delta.transpose();
-        }
+        g.getEdgeCosts(yzeItr) += delta;
       }
 
       bool nullCostEdge = tryNormaliseEdgeMatrix(yzeItr);
@@ -37,6 +37,33 @@ class SDDbgValue;
 class TargetLowering;
 class TargetSelectionDAGInfo;
 
+/// SDVTListNode - A uniqued list of value types, as returned by
+/// SelectionDAG::getVTList.  These live in a FoldingSet so that looking up a
+/// list does not have to scan every list the DAG has ever created.
+class SDVTListNode : public FoldingSetNode {
+  const EVT *VTs;
+  unsigned int NumVTs;
+public:
+  SDVTListNode(const EVT *VT, unsigned int Num) : VTs(VT), NumVTs(Num) {}
+
+  SDVTList getSDVTList() const {
+    SDVTList Result = {VTs, NumVTs};
+    return Result;
+  }
+
+  void Profile(FoldingSetNodeID &ID) const {
+    Profile(ID, VTs, NumVTs);
+  }
+
+  static void Profile(FoldingSetNodeID &ID, const EVT *VTs, unsigned NumVTs) {
+    ID.AddInteger(NumVTs);
+    for (unsigned i = 0; i != NumVTs; ++i) {
+      EVT VT = VTs[i];
+      ID.AddInteger(VT.getRawBits());
+    }
+  }
+};
+
 template<> struct ilist_traits<SDNode> : public ilist_default_traits<SDNode> {
 private:
   mutable ilist_half_node<SDNode> Sentinel;
@@ -1063,8 +1090,8 @@ private:
 
   void allnodes_clear();
 
-  /// VTList - List of non-single value types.
-  std::vector<SDVTList> VTList;
+  /// VTListMap - Uniqued lists of non-single value types.
+  FoldingSet<SDVTListNode> VTListMap;
 
   /// CondCodeNodes - Maps to auto-CSE operations.
   std::vector<CondCodeSDNode*> CondCodeNodes;
@@ -42,6 +42,7 @@ class JITMemoryManager;
 class MachineCodeInfo;
 class Module;
 class MutexGuard;
+class ObjectCache;
 class TargetData;
 class Triple;
 class Type;
@@ -249,6 +250,20 @@ public:
                      "EE!");
   }
 
+  /// setObjectCache - Set the cache consulted before generating code for a
+  /// module and notified of every object file generated.  The engine does
+  /// not take ownership of the cache.  It must be set before any code is
+  /// generated, i.e. before the first call to getPointerToFunction or
+  /// runFunction.
+  virtual void setObjectCache(ObjectCache *) {
+    llvm_unreachable("No support for an object cache with this EE!");
+  }
+
+  /// finalizeObject - Generate code for all modules now, if the engine defers
+  /// it, so that the caller can prepare it for execution (for example by
+  /// invalidating the instruction cache) before running any of it.
+  virtual void finalizeObject() {}
+
   /// runStaticConstructorsDestructors - This method is used to execute all of
   /// the static constructors or destructors for a program.
   ///
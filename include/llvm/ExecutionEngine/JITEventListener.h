@@ -26,6 +26,7 @@ class Function;
 class MachineFunction;
 class OProfileWrapper;
 class IntelJITEventsWrapper;
+class raw_ostream;
 
 /// JITEvent_EmittedFunctionDetails - Helper struct for containing information
 /// about a generated machine code function.
@@ -76,6 +77,20 @@ public:
   /// matching NotifyFreeingMachineCode call.
   virtual void NotifyFreeingMachineCode(void *) {}
 
+  // Construct a PerfJITEventListener, which records the JITted functions in
+  // /tmp/perf-<pid>.map so that the Linux perf tool can symbolize them.
+  // Entries are written out in batches, and all of them once the listener is
+  // destroyed.  Set FlushEachEntry to write each entry immediately, for
+  // perf top or for processes that may crash.  Returns null on hosts without
+  // perf map support.
+  static JITEventListener *createPerfJITEventListener(
+                                      bool FlushEachEntry = false);
+
+  // Construct a PerfJITEventListener that writes its map to the given stream
+  static JITEventListener *createPerfJITEventListener(
+                                      raw_ostream &OS,
+                                      bool FlushEachEntry = false);
+
 #if LLVM_USE_INTEL_JITEVENTS
   // Construct an IntelJITEventListener
   static JITEventListener *createIntelJITEventListener();
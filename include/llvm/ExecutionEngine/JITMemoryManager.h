@@ -42,6 +42,11 @@ public:
   /// start execution, the code pages may need permissions changed.
   virtual void setMemoryExecutable() = 0;
 
+  /// finalizeMemory - MCJIT calls this once the objects it has just loaded
+  /// have been relocated, before any of their code runs, so that the memory
+  /// manager can make the new code executable.  The default does nothing.
+  virtual void finalizeMemory() {}
+
   /// setPoisonMemory - Setting this flag to true makes the memory manager
   /// garbage values over freed memory.  This is useful for testing and
   /// debugging, and may be turned on by default in debug mode.
@@ -0,0 +1,48 @@
+//===-- ObjectCache.h - Class definition for the ObjectCache ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Interface through which MCJIT clients can reuse object files compiled by an
+// earlier run instead of generating code again.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_OBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_OBJECTCACHE_H
+
+namespace llvm {
+
+class MemoryBuffer;
+class Module;
+
+/// ObjectCache - This is the base class for clients that want to cache the
+/// object files MCJIT generates.  MCJIT asks the cache for an object before
+/// running code generation on a module, and hands it every object it does
+/// generate.  How modules are keyed is up to the implementation; it must only
+/// return an object that was compiled from identical IR with identical
+/// target options.
+class ObjectCache {
+  ObjectCache(const ObjectCache &);     // DO NOT IMPLEMENT
+  void operator=(const ObjectCache &);  // DO NOT IMPLEMENT
+public:
+  ObjectCache() {}
+  virtual ~ObjectCache();
+
+  /// notifyObjectCompiled - Called after an object file has been generated
+  /// for M.  Obj is only valid for the duration of the call.
+  virtual void notifyObjectCompiled(const Module *M,
+                                    const MemoryBuffer *Obj) = 0;
+
+  /// getObject - Return the cached object file for M, or null if there is
+  /// none.  The caller takes ownership of the returned buffer.
+  virtual MemoryBuffer *getObject(const Module *M) = 0;
+};
+
+} // End llvm namespace
+
+#endif
@@ -59,7 +59,8 @@ class RuntimeDyld {
   RTDyldMemoryManager *MM;
 protected:
   // Change the address associated with a section when resolving relocations.
-  // Any relocations already associated with the symbol will be re-resolved.
+  // Any relocations already resolved against or within the section are
+  // re-resolved.
   void reassignSectionAddress(unsigned SectionID, uint64_t Addr);
 public:
   RuntimeDyld(RTDyldMemoryManager*);
@@ -73,13 +74,16 @@ public:
   /// and resolve relocatons based on where they put it).
   void *getSymbolAddress(StringRef Name);
 
-  /// Resolve the relocations for all symbols we currently know about.
+  /// Resolve the relocations that have not been resolved yet.  Objects loaded
+  /// after a call are resolved by the next call without touching the code
+  /// resolved before; only remapping a section re-resolves relocations.
   void resolveRelocations();
 
   /// mapSectionAddress - map a section to its target address space value.
   /// Map the address of a JIT section as returned from the memory manager
   /// to the address in the target process as the running code will see it.
-  /// This is the address which will be used for relocation resolution.
+  /// This is the address which will be used for relocation resolution.  A
+  /// section may be mapped before or after its relocations are resolved.
   void mapSectionAddress(void *LocalAddress, uint64_t TargetAddress);
 
   StringRef getErrorString();
@@ -0,0 +1,165 @@
+//===- SectionMemoryManager.h - Memory manager for MCJIT/RtDyld -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the declaration of a section-based memory manager used by
+// the MCJIT execution engine.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_SECTIONMEMORYMANAGER_H
+#define LLVM_EXECUTIONENGINE_SECTIONMEMORYMANAGER_H
+
+#include "llvm/ExecutionEngine/JITMemoryManager.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Memory.h"
+
+namespace llvm {
+
+/// SectionMemoryManager - A memory manager for MCJIT that carves the sections
+/// of loaded objects out of large slabs of mapped memory.  Code and data are
+/// kept in separate slabs, so that code can be kept write-xor-execute: code
+/// sections are allocated writable, and finalizeMemory() makes the ones
+/// allocated since its last call read-only and executable.  Code finalized
+/// earlier is never made writable again, so it can keep running on other
+/// threads while more objects are loaded.
+///
+/// All memory is released when the memory manager is destroyed, that is,
+/// together with the execution engine that owns it.
+class SectionMemoryManager : public JITMemoryManager {
+  SectionMemoryManager(const SectionMemoryManager&); // DO NOT IMPLEMENT
+  void operator=(const SectionMemoryManager&);       // DO NOT IMPLEMENT
+
+public:
+  /// MemoryUsage - A snapshot of how much memory the manager holds.  The
+  /// difference between the reserved and the used bytes is lost to
+  /// alignment padding and to the unused tails of slabs.
+  struct MemoryUsage {
+    size_t CodeBytesReserved;
+    size_t CodeBytesUsed;
+    size_t DataBytesReserved;
+    size_t DataBytesUsed;
+    unsigned NumCodeSlabs;
+    unsigned NumDataSlabs;
+  };
+
+  /// SectionMemoryManager - Create a memory manager that allocates slabs of
+  /// SlabSize bytes.  If UseHugePages is set, code slabs are requested to be
+  /// backed by huge pages, which pays off for large amounts of code.
+  explicit SectionMemoryManager(size_t SlabSize = 1024 * 1024,
+                                bool UseHugePages = false);
+  virtual ~SectionMemoryManager();
+
+  virtual uint8_t *allocateCodeSection(uintptr_t Size, unsigned Alignment,
+                                       unsigned SectionID);
+
+  virtual uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment,
+                                       unsigned SectionID);
+
+  /// setMemoryWritable - Does nothing: new code sections are always
+  /// allocated writable.
+  virtual void setMemoryWritable() {}
+
+  /// setMemoryExecutable - Same as finalizeMemory().
+  virtual void setMemoryExecutable() { finalizeMemory(); }
+
+  /// finalizeMemory - Make the code sections allocated since the last call
+  /// readable and executable, but not writable, and invalidate the
+  /// instruction cache for them.
+  virtual void finalizeMemory();
+
+  /// invalidateInstructionCache - Invalidate the instruction cache for all
+  /// code slabs.
+  virtual void invalidateInstructionCache();
+
+  virtual void *getPointerToNamedFunction(const std::string &Name,
+                                          bool AbortOnFailure = true);
+
+  /// getMemoryUsage - Return how much memory is reserved and in use.
+  MemoryUsage getMemoryUsage() const;
+
+  virtual size_t GetDefaultCodeSlabSize() { return SlabSize; }
+  virtual size_t GetDefaultDataSlabSize() { return SlabSize; }
+  virtual unsigned GetNumCodeSlabs() { return CodeMem.Slabs.size(); }
+  virtual unsigned GetNumDataSlabs() { return DataMem.Slabs.size(); }
+
+  // MCJIT doesn't use the following functions, so we don't need to implement
+  // them.
+  virtual void setPoisonMemory(bool poison) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual void AllocateGOT() {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual uint8_t *getGOTBase() const {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual uint8_t *startFunctionBody(const Function *F,
+                                     uintptr_t &ActualSize) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual uint8_t *allocateStub(const GlobalValue *F, unsigned StubSize,
+                                unsigned Alignment) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual void endFunctionBody(const Function *F, uint8_t *FunctionStart,
+                               uint8_t *FunctionEnd) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual uint8_t *allocateSpace(intptr_t Size, unsigned Alignment) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual uint8_t *allocateGlobal(uintptr_t Size, unsigned Alignment) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual void deallocateFunctionBody(void *Body) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual uint8_t *startExceptionTable(const Function *F,
+                                       uintptr_t &ActualSize) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual void endExceptionTable(const Function *F, uint8_t *TableStart,
+                                 uint8_t *TableEnd, uint8_t *FrameRegister) {
+    llvm_unreachable("Unexpected call!");
+  }
+  virtual void deallocateExceptionTable(void *ET) {
+    llvm_unreachable("Unexpected call!");
+  }
+
+private:
+  /// MemoryGroup - The slabs holding one kind of section.  Sections are
+  /// bump-allocated out of the last slab.
+  struct MemoryGroup {
+    SmallVector<sys::MemoryBlock, 8> Slabs;
+    uintptr_t Cur;
+    uintptr_t End;
+    size_t BytesUsed;
+
+    MemoryGroup() : Cur(0), End(0), BytesUsed(0) {}
+  };
+
+  uint8_t *allocateSection(MemoryGroup &Group, uintptr_t Size,
+                           unsigned Alignment, unsigned Flags);
+  static size_t getReservedBytes(const MemoryGroup &Group);
+
+  MemoryGroup CodeMem;
+  MemoryGroup DataMem;
+
+  /// PendingCode - The pages holding the code sections allocated since the
+  /// last call to finalizeMemory().
+  SmallVector<sys::MemoryBlock, 16> PendingCode;
+
+  size_t SlabSize;
+  bool UseHugePages;
+};
+
+} // End llvm namespace
+
+#endif
@@ -105,6 +105,7 @@ namespace {
       (void) llvm::createObjCARCOptPass();
       (void) llvm::createProfileEstimatorPass();
       (void) llvm::createProfileVerifierPass();
+      (void) llvm::createProfileMetadataPass();
       (void) llvm::createPathProfileVerifierPass();
       (void) llvm::createProfileLoaderPass();
       (void) llvm::createPathProfileLoaderPass();
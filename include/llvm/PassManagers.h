@@ -456,6 +456,57 @@ public:
 
 Timer *getPassTimer(Pass *);
 
+//===----------------------------------------------------------------------===//
+// -pass-profile support
+//
+
+/// PassProfileTraits - Describes an IR unit that passes run on to
+/// -pass-profile.  Each pass manager specializes this for its unit type, with
+///   static const char *getCategory();
+///   static std::string getName(UnitT &Unit);
+///   static unsigned countInstructions(UnitT &Unit);
+/// countInstructions is called both before and after the pass runs, so it
+/// must only look at IR that the pass cannot delete.
+template<typename UnitT> struct PassProfileTraits;
+
+/// PassProfileEvent - The part of PassProfileRegion that does not depend on
+/// the unit type.
+class PassProfileEvent {
+protected:
+  Pass *P;
+  std::string UnitName;
+  uint64_t Begin, End;
+  unsigned InstrsBefore;
+  size_t MallocBefore, MallocAfter;
+
+  /// PassProfileEvent - P is only kept if -pass-profile is enabled.
+  explicit PassProfileEvent(Pass *P);
+  void start(const std::string &Name, unsigned Instrs);
+  void stop();
+  void record(const char *Category, unsigned InstrsAfter);
+};
+
+/// PassProfileRegion - Record the execution of a pass on an IR unit for the
+/// lifetime of this object, if -pass-profile is enabled.  Like TimeRegion,
+/// this is placed around the call into the pass.
+template<typename UnitT>
+class PassProfileRegion : PassProfileEvent {
+  typedef PassProfileTraits<UnitT> Traits;
+  UnitT &Unit;
+  PassProfileRegion(const PassProfileRegion &); // DO NOT IMPLEMENT
+  void operator=(const PassProfileRegion &);    // DO NOT IMPLEMENT
+public:
+  PassProfileRegion(Pass *P, UnitT &Unit) : PassProfileEvent(P), Unit(Unit) {
+    if (this->P)
+      start(Traits::getName(Unit), Traits::countInstructions(Unit));
+  }
+  ~PassProfileRegion() {
+    if (!P) return;
+    stop();
+    record(Traits::getCategory(), Traits::countInstructions(Unit));
+  }
+};
+
 }
 
 #endif
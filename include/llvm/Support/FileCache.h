@@ -0,0 +1,71 @@
+//===- llvm/Support/FileCache.h - On-disk cache of files --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares FileCache, a directory of generated files that can be
+// shared by several processes, such as the native objects cached by libLTO
+// and by lli's MCJIT object cache.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_FILECACHE_H
+#define LLVM_SUPPORT_FILECACHE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <string>
+
+namespace llvm {
+
+class MemoryBuffer;
+
+/// FileCache - A directory of cache entries, each named after a key that is
+/// the MD5 digest of everything the cached data depends on.  An entry is a
+/// single file, <key>.cache, holding a one-line header followed by the data.
+/// The header names the kind of cache, repeats the key and records the size
+/// of the data, so a truncated, misnamed or foreign file is never used.
+///
+/// Entries are published by renaming complete temporary files into place, so
+/// processes sharing a directory never observe partial entries.  Clients that
+/// want to avoid producing the same entry twice can lock getEntryPath(Key)
+/// with a LockFileManager.
+class FileCache {
+  std::string Dir;
+  std::string Magic;
+
+public:
+  /// FileCache - Create a cache in the directory Dir, which is created when
+  /// the first entry is stored.  Magic identifies the kind of data stored;
+  /// entries written with a different magic string are ignored.
+  FileCache(StringRef Dir, StringRef Magic) : Dir(Dir), Magic(Magic) {}
+
+  /// getKey - Return the key for data that depends on exactly the bytes of
+  /// Inputs.  Callers should include the LLVM version in Inputs if the data
+  /// is generated by LLVM.
+  static std::string getKey(StringRef Inputs);
+
+  /// getEntryPath - Return the path of the entry for Key.
+  std::string getEntryPath(StringRef Key) const;
+
+  /// lookup - Return the data stored for Key, or null if there is no valid
+  /// entry.  Large entries are mapped rather than read, so the buffer may be
+  /// read-only.  A successful lookup marks the entry as recently used.
+  MemoryBuffer *lookup(StringRef Key) const;
+
+  /// store - Store Data as the entry for Key, replacing any existing entry.
+  /// Returns true and sets ErrMsg on error.
+  bool store(StringRef Key, StringRef Data, std::string &ErrMsg);
+
+  /// prune - Remove the least recently used entries until the entries take
+  /// up at most MaxSize bytes.
+  void prune(uint64_t MaxSize);
+};
+
+} // end namespace llvm
+
+#endif
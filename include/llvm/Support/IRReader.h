@@ -59,13 +59,29 @@ namespace llvm {
   inline Module *getLazyIRFileModule(const std::string &Filename,
                                      SMDiagnostic &Err,
                                      LLVMContext &Context) {
+    // The bitcode reader does not need a null terminator.  Not asking for one
+    // lets MemoryBuffer map any large file instead of reading it, so the
+    // pages holding function bodies that are never materialized are never
+    // faulted in.
     OwningPtr<MemoryBuffer> File;
-    if (error_code ec = MemoryBuffer::getFileOrSTDIN(Filename.c_str(), File)) {
+    error_code ec;
+    if (Filename == "-")
+      ec = MemoryBuffer::getSTDIN(File);
+    else
+      ec = MemoryBuffer::getFile(Filename, File, -1,
+                                 /*RequiresNullTerminator=*/false);
+    if (ec) {
       Err = SMDiagnostic(Filename, SourceMgr::DK_Error,
                          "Could not open input file: " + ec.message());
       return 0;
     }
 
+    // The assembly parser does need the terminator.
+    if (!isBitcode((const unsigned char *)File->getBufferStart(),
+                   (const unsigned char *)File->getBufferEnd()))
+      File.reset(MemoryBuffer::getMemBufferCopy(File->getBuffer(),
+                                                File->getBufferIdentifier()));
+
     return getLazyIRModule(File.take(), Err, Context);
   }
 
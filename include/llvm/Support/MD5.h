@@ -0,0 +1,54 @@
+//===- llvm/Support/MD5.h - MD5 message digest ------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares an implementation of the MD5 message digest (RFC 1321).
+//
+// Unlike hash_value, an MD5 digest is the same on every host and in every
+// build, which makes it suitable for naming things that are stored on disk,
+// such as cache entries.  It is not meant to resist deliberate collisions.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_MD5_H
+#define LLVM_SUPPORT_MD5_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm {
+
+class MD5 {
+  uint32_t A, B, C, D;
+  uint64_t Length;
+  uint8_t Buffer[64];
+
+  void body(const uint8_t *Block);
+
+public:
+  typedef uint8_t MD5Result[16];
+
+  MD5();
+
+  /// update - Add Data to the message being digested.
+  void update(ArrayRef<uint8_t> Data);
+  void update(StringRef Str);
+
+  /// final - Finish the digest and store it in Result.  The object must not
+  /// be updated afterwards.
+  void final(MD5Result &Result);
+
+  /// stringifyResult - Write Result to Str as 32 lowercase hex digits.
+  static void stringifyResult(const MD5Result &Result, SmallString<32> &Str);
+};
+
+} // end namespace llvm
+
+#endif
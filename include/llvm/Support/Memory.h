@@ -43,6 +43,43 @@ namespace sys {
   /// @brief An abstraction for memory operations.
   class Memory {
   public:
+    enum ProtectionFlags {
+      MF_READ  = 0x1000000,
+      MF_WRITE = 0x2000000,
+      MF_EXEC  = 0x4000000,
+      /// Ask for the block to be backed by huge pages (2MB on x86-64 Linux)
+      /// to save TLB entries.  This is only a hint: it is ignored where the
+      /// system does not support it.
+      MF_HUGE_PAGES = 0x8000000
+    };
+
+    /// allocateMappedMemory - Allocate at least \p NumBytes of page aligned
+    /// memory with the access given by \p Flags, a combination of
+    /// ProtectionFlags.  Unlike AllocateRWX, the access can be changed later
+    /// with protectMappedMemory, so that code can be written and executed
+    /// without the memory ever being writable and executable at once.
+    ///
+    /// On success, this returns a non-null memory block, otherwise it returns
+    /// a null memory block and fills in *ErrMsg.
+    static MemoryBlock allocateMappedMemory(size_t NumBytes, unsigned Flags,
+                                            std::string *ErrMsg = 0);
+
+    /// releaseMappedMemory - Release a block of memory that was allocated with
+    /// allocateMappedMemory.
+    ///
+    /// On success, this returns false, otherwise it returns true and fills
+    /// in *ErrMsg.
+    static bool releaseMappedMemory(MemoryBlock &M, std::string *ErrMsg = 0);
+
+    /// protectMappedMemory - Change the access to a block of memory that was
+    /// allocated with allocateMappedMemory to \p Flags.  Making a block
+    /// executable also invalidates the instruction cache for it.
+    ///
+    /// On success, this returns false, otherwise it returns true and fills
+    /// in *ErrMsg.
+    static bool protectMappedMemory(const MemoryBlock &M, unsigned Flags,
+                                    std::string *ErrMsg = 0);
+
     /// This method allocates a block of Read/Write/Execute memory that is
     /// suitable for executing dynamically generated code (e.g. JIT). An
     /// attempt to allocate \p NumBytes bytes of virtual memory is made.
@@ -51,6 +51,10 @@ public:
   template<class SubClass>
   void Deallocate(SubClass* E) { return Base.Deallocate(Allocator, E); }
 
+  /// getAllocator - Return the wrapped allocator, e.g. to find out how much
+  /// memory it has obtained.
+  const AllocatorType &getAllocator() const { return Allocator; }
+
   void PrintStats() { Base.PrintStats(); }
 };
 
@@ -33,6 +33,7 @@ class TimeRecord {
   double UserTime;       // User time elapsed
   double SystemTime;     // System time elapsed
   ssize_t MemUsed;       // Memory allocated (in bytes)
+  friend class Timer;
 public:
   TimeRecord() : WallTime(0), UserTime(0), SystemTime(0), MemUsed(0) {}
   
@@ -118,6 +119,12 @@ public:
   ///
   void stopTimer();
 
+  /// addWallTime - Add Seconds of wall time measured by the caller, as if the
+  /// timer had been running for that long.  This is for code too hot to start
+  /// and stop a timer around: it can accumulate durations from a cheap clock
+  /// and hand them over in bulk.
+  void addWallTime(double Seconds);
+
 private:
   friend class TimerGroup;
 };
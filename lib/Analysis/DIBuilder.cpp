@@ -17,6 +17,7 @@
 #include "llvm/IntrinsicInst.h"
 #include "llvm/Module.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Atomic.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Dwarf.h"
 
@@ -944,15 +945,17 @@ DILexicalBlockFile DIBuilder::createLexicalBlockFile(DIDescriptor Scope,
 
 DILexicalBlock DIBuilder::createLexicalBlock(DIDescriptor Scope, DIFile File,
                                              unsigned Line, unsigned Col) {
-  // Defeat MDNode uniqing for lexical blocks by using unique id.
-  static unsigned int unique_id = 0;
+  // Defeat MDNode uniqing for lexical blocks by using unique id.  The counter
+  // is shared by every context, so bump it atomically.
+  static volatile sys::cas_flag unique_id = 0;
+  unsigned ID = sys::AtomicIncrement(&unique_id) - 1;
   Value *Elts[] = {
     GetTagConstant(VMContext, dwarf::DW_TAG_lexical_block),
     getNonCompileUnitScope(Scope),
     ConstantInt::get(Type::getInt32Ty(VMContext), Line),
     ConstantInt::get(Type::getInt32Ty(VMContext), Col),
     File,
-    ConstantInt::get(Type::getInt32Ty(VMContext), unique_id++)
+    ConstantInt::get(Type::getInt32Ty(VMContext), ID)
   };
   return DILexicalBlock(MDNode::get(VMContext, Elts));
 }
@@ -34,6 +34,26 @@ MaxIterations("max-cg-scc-iterations", cl::ReallyHidden, cl::init(4));
 
 STATISTIC(MaxSCCIterations, "Maximum CGSCCPassMgr iterations on one SCC");
 
+namespace llvm {
+template<> struct PassProfileTraits<CallGraphSCC> {
+  static const char *getCategory() { return "scc"; }
+  /// getName - Name an SCC after its first function.
+  static std::string getName(CallGraphSCC &SCC) {
+    if (Function *F = (*SCC.begin())->getFunction())
+      return F->getName();
+    return "<<null function>>";
+  }
+  static unsigned countInstructions(CallGraphSCC &SCC) {
+    unsigned Count = 0;
+    for (CallGraphSCC::iterator I = SCC.begin(), E = SCC.end(); I != E; ++I)
+      if (Function *F = (*I)->getFunction())
+        for (Function::iterator BB = F->begin(), BE = F->end(); BB != BE; ++BB)
+          Count += BB->size();
+    return Count;
+  }
+};
+}
+
 //===----------------------------------------------------------------------===//
 // CGPassManager
 //
@@ -118,6 +138,7 @@ bool CGPassManager::RunPassOnSCC(Pass *P, CallGraphSCC &CurSCC,
 
     {
       TimeRegion PassTimer(getPassTimer(CGSP));
+      PassProfileRegion<CallGraphSCC> PassProfile(CGSP, CurSCC);
       Changed = CGSP->runOnSCC(CurSCC);
     }
     
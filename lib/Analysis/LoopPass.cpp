@@ -49,6 +49,30 @@ public:
 };
 
 char PrintLoopPass::ID = 0;
+
+/// ProfiledLoop - The unit that -pass-profile records loop pass executions
+/// against.  A loop pass may delete its loop, so instructions are counted over
+/// the function that holds it.
+struct ProfiledLoop {
+  Loop *L;
+  Function *F;
+  explicit ProfiledLoop(Loop *L) : L(L), F(L->getHeader()->getParent()) {}
+};
+}
+
+namespace llvm {
+template<> struct PassProfileTraits<ProfiledLoop> {
+  static const char *getCategory() { return "loop"; }
+  static std::string getName(ProfiledLoop &PL) {
+    return (PL.F->getName() + ":" + PL.L->getHeader()->getName()).str();
+  }
+  static unsigned countInstructions(ProfiledLoop &PL) {
+    unsigned Count = 0;
+    for (Function::iterator I = PL.F->begin(), E = PL.F->end(); I != E; ++I)
+      Count += I->size();
+    return Count;
+  }
+};
 }
 
 //===----------------------------------------------------------------------===//
@@ -220,6 +244,8 @@ bool LPPassManager::runOnFunction(Function &F) {
       {
         PassManagerPrettyStackEntry X(P, *CurrentLoop->getHeader());
         TimeRegion PassTimer(getPassTimer(P));
+        ProfiledLoop PL(CurrentLoop);
+        PassProfileRegion<ProfiledLoop> PassProfile(P, PL);
 
         Changed |= P->runOnLoop(CurrentLoop, *this);
       }
@@ -193,16 +193,23 @@ Archive::~Archive() {
 
 
 
+/// isDefinition - Return true if GV is defined in its module.  The modules
+/// scanned here are loaded lazily, so a function whose body has not been
+/// materialized yet still counts as a definition.
+static bool isDefinition(const GlobalValue &GV) {
+  return !GV.isDeclaration() || GV.isMaterializable();
+}
+
 static void getSymbols(Module*M, std::vector<std::string>& symbols) {
   // Loop over global variables
   for (Module::global_iterator GI = M->global_begin(), GE=M->global_end(); GI != GE; ++GI)
-    if (!GI->isDeclaration() && !GI->hasLocalLinkage())
+    if (isDefinition(*GI) && !GI->hasLocalLinkage())
       if (!GI->getName().empty())
         symbols.push_back(GI->getName());
 
   // Loop over functions
   for (Module::iterator FI = M->begin(), FE = M->end(); FI != FE; ++FI)
-    if (!FI->isDeclaration() && !FI->hasLocalLinkage())
+    if (isDefinition(*FI) && !FI->hasLocalLinkage())
       if (!FI->getName().empty())
         symbols.push_back(FI->getName());
 
@@ -226,9 +233,12 @@ bool llvm::GetBitcodeSymbols(const sys::Path& fName,
     return true;
   }
 
-  Module *M = ParseBitcodeFile(Buffer.get(), Context, ErrMsg);
+  // Only the module-level records are needed to find the symbols, so don't
+  // parse any function bodies.
+  Module *M = getLazyBitcodeModule(Buffer.get(), Context, ErrMsg);
   if (!M)
     return true;
+  Buffer.take(); // The module owns the buffer now.
 
   // Get the symbols
   getSymbols(M, symbols);
@@ -248,9 +258,12 @@ llvm::GetBitcodeSymbols(const char *BufPtr, unsigned Length,
   OwningPtr<MemoryBuffer> Buffer(
     MemoryBuffer::getMemBufferCopy(StringRef(BufPtr, Length),ModuleID.c_str()));
 
-  Module *M = ParseBitcodeFile(Buffer.get(), Context, ErrMsg);
+  // Load the module lazily; function bodies are only materialized if the
+  // caller goes on to link it.
+  Module *M = getLazyBitcodeModule(Buffer.get(), Context, ErrMsg);
   if (!M)
     return 0;
+  Buffer.take(); // The module owns the buffer now.
 
   // Get the symbols
   getSymbols(M, symbols);
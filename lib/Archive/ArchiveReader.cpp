@@ -625,11 +625,13 @@ bool Archive::isBitcodeArchive() {
     MemoryBuffer *Buffer =
       MemoryBuffer::getMemBufferCopy(StringRef(I->getData(), I->getSize()),
                                      FullMemberName.c_str());
-    Module *M = ParseBitcodeFile(Buffer, Context);
-    delete Buffer;
-    if (!M)
+    // Reading the module header is enough to tell; skip the function bodies.
+    Module *M = getLazyBitcodeModule(Buffer, Context);
+    if (!M) {
+      delete Buffer;
       return false;  // Couldn't parse bitcode, not a bitcode archive.
-    delete M;
+    }
+    delete M; // Also deletes the buffer.
     return true;
   }
   
@@ -21,6 +21,7 @@
 #include "llvm/CodeGen/LiveIntervalAnalysis.h"
 #include "llvm/CodeGen/LiveRangeEdit.h"
 #include "llvm/CodeGen/LiveStackAnalysis.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
 #include "llvm/CodeGen/MachineDominators.h"
 #include "llvm/CodeGen/MachineInstrBundle.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
@@ -58,6 +59,7 @@ class InlineSpiller : public Spiller {
   AliasAnalysis *AA;
   MachineDominatorTree &MDT;
   MachineLoopInfo &Loops;
+  MachineBlockFrequencyInfo &MBFI;
   VirtRegMap &VRM;
   MachineFrameInfo &MFI;
   MachineRegisterInfo &MRI;
@@ -142,6 +144,7 @@ public:
       AA(&pass.getAnalysis<AliasAnalysis>()),
       MDT(pass.getAnalysis<MachineDominatorTree>()),
       Loops(pass.getAnalysis<MachineLoopInfo>()),
+      MBFI(pass.getAnalysis<MachineBlockFrequencyInfo>()),
       VRM(vrm),
       MFI(*mf.getFrameInfo()),
       MRI(mf.getRegInfo()),
@@ -375,7 +378,7 @@ void InlineSpiller::propagateSiblingValue(SibValueMap::iterator SVI,
     // Should this value be propagated as a preferred spill candidate?  We don't
     // propagate values of registers that are about to spill.
     bool PropSpill = !DisableHoisting && !isRegToSpill(SV.SpillReg);
-    unsigned SpillDepth = ~0u;
+    BlockFrequency SpillFreq;
 
     for (TinyPtrVector<VNInfo*>::iterator DepI = Deps->begin(),
          DepE = Deps->end(); DepI != DepE; ++DepI) {
@@ -429,13 +432,15 @@ void InlineSpiller::propagateSiblingValue(SibValueMap::iterator SVI,
           }
         } else {
           // DepSV is in a different block.
-          if (SpillDepth == ~0u)
-            SpillDepth = Loops.getLoopDepth(SV.SpillMBB);
+          if (SpillFreq.getFrequency() == 0)
+            SpillFreq = MBFI.getBlockFreq(SV.SpillMBB);
 
-          // Also hoist spills to blocks with smaller loop depth, but make sure
+          // Also hoist spills to blocks that execute less often, but make sure
           // that the new value dominates.  Non-phi dependents are always
-          // dominated, phis need checking.
-          if ((Loops.getLoopDepth(DepSV.SpillMBB) > SpillDepth) &&
+          // dominated, phis need checking.  Unlike loop depth, block frequency
+          // also keeps spills in a cold path of a loop from being hoisted to a
+          // preheader that runs on every entry.
+          if ((MBFI.getBlockFreq(DepSV.SpillMBB) > SpillFreq) &&
               (!DepSVI->first->isPHIDef() ||
                MDT.dominates(SV.SpillMBB, DepSV.SpillMBB))) {
             Changed = true;
@@ -133,6 +133,15 @@ collectInterferingVRegs(unsigned MaxInterferingRegs) {
       return 0;
     }
 
+    // Likewise when VirtReg lies entirely before or after the union.  The
+    // union's bounds are kept in the root node, so this is much cheaper than
+    // searching the map, and it catches sparsely used register units.
+    if (VirtReg->endIndex() <= LiveUnion->startIndex() ||
+        LiveUnion->endIndex() <= VirtReg->beginIndex()) {
+      SeenAllInterferences = true;
+      return 0;
+    }
+
     // In most cases, the union will start before VirtReg.
     VirtRegI = VirtReg->begin();
     LiveUnionI.setMap(LiveUnion->getMap());
@@ -73,6 +73,7 @@ public:
   SegmentIter find(SlotIndex x) { return Segments.find(x); }
   bool empty() const { return Segments.empty(); }
   SlotIndex startIndex() const { return Segments.start(); }
+  SlotIndex endIndex() const { return Segments.stop(); }
 
   // Provide public access to the underlying map to allow overlap iteration.
   typedef LiveSegments Map;
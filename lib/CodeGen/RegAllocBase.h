@@ -96,6 +96,12 @@ protected:
     return PhysReg2LiveUnion[PhysReg];
   }
 
+  // Get the memory held by the LiveIntervalUnions, in bytes.
+  size_t getLiveUnionMemory() const {
+    return UnionAllocator.getAllocator().getTotalMemory() +
+      PhysReg2LiveUnion.size() * sizeof(LiveIntervalUnion);
+  }
+
   // Invalidate all cached information about virtual registers - live ranges may
   // have changed.
   void invalidateVirtRegs() { ++UserTag; }
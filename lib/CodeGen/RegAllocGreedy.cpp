@@ -30,12 +30,15 @@
 #include "llvm/CodeGen/LiveIntervalAnalysis.h"
 #include "llvm/CodeGen/LiveRangeEdit.h"
 #include "llvm/CodeGen/LiveStackAnalysis.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
 #include "llvm/CodeGen/MachineDominators.h"
+#include "llvm/CodeGen/MachineFrameInfo.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineLoopInfo.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/CodeGen/Passes.h"
 #include "llvm/CodeGen/RegAllocRegistry.h"
+#include "llvm/Target/TargetInstrInfo.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
@@ -50,6 +53,12 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumSegments,     "Number of live segments considered for allocation");
+STATISTIC(PeakMemoryKB,    "Peak memory held by live ranges (KB)");
+STATISTIC(NumDynSpills,    "Spill slot stores per function entry, weighted by "
+                           "block frequency");
+STATISTIC(NumDynReloads,   "Spill slot loads per function entry, weighted by "
+                           "block frequency");
 
 static cl::opt<SplitEditor::ComplementSpillMode>
 SplitSpillMode("split-spill-mode", cl::Hidden,
@@ -75,6 +84,7 @@ class RAGreedy : public MachineFunctionPass,
   SlotIndexes *Indexes;
   MachineDominatorTree *DomTree;
   MachineLoopInfo *Loops;
+  MachineBlockFrequencyInfo *MBFI;
   EdgeBundles *Bundles;
   SpillPlacement *SpillPlacer;
   LiveDebugVariables *DebugVars;
@@ -83,6 +93,7 @@ class RAGreedy : public MachineFunctionPass,
   std::auto_ptr<Spiller> SpillerInstance;
   std::priority_queue<std::pair<unsigned, unsigned> > Queue;
   unsigned NextCascade;
+  unsigned NumDequeued;
 
   // Live ranges pass through a number of stages as we try to allocate them.
   // Some of the stages may also create new live ranges:
@@ -291,6 +302,8 @@ private:
     SmallVectorImpl<LiveInterval*>&);
   unsigned trySplit(LiveInterval&, AllocationOrder&,
                     SmallVectorImpl<LiveInterval*>&);
+  void sampleMemoryUsage();
+  void reportDynamicSpillCost();
 };
 } // end anonymous namespace
 
@@ -327,6 +340,7 @@ RAGreedy::RAGreedy(): MachineFunctionPass(ID) {
   initializeLiveStacksPass(*PassRegistry::getPassRegistry());
   initializeMachineDominatorTreePass(*PassRegistry::getPassRegistry());
   initializeMachineLoopInfoPass(*PassRegistry::getPassRegistry());
+  initializeMachineBlockFrequencyInfoPass(*PassRegistry::getPassRegistry());
   initializeVirtRegMapPass(*PassRegistry::getPassRegistry());
   initializeEdgeBundlesPass(*PassRegistry::getPassRegistry());
   initializeSpillPlacementPass(*PassRegistry::getPassRegistry());
@@ -349,6 +363,8 @@ void RAGreedy::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addPreserved<MachineDominatorTree>();
   AU.addRequired<MachineLoopInfo>();
   AU.addPreserved<MachineLoopInfo>();
+  AU.addRequired<MachineBlockFrequencyInfo>();
+  AU.addPreserved<MachineBlockFrequencyInfo>();
   AU.addRequired<VirtRegMap>();
   AU.addPreserved<VirtRegMap>();
   AU.addRequired<EdgeBundles>();
@@ -1667,8 +1683,36 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
 //                            Main Entry Point
 //===----------------------------------------------------------------------===//
 
+/// heapBytes - Return the memory V has allocated beyond its inline storage.
+template<typename T, unsigned N>
+static size_t heapBytes(const SmallVector<T, N> &V) {
+  return V.capacity() > N ? V.capacity_in_bytes() : 0;
+}
+
+/// sampleMemoryUsage - Update the peak memory reported by -stats: the live
+/// intervals with their segments and value numbers, and the live interval
+/// unions.  Walking all intervals is too slow to do unconditionally.
+void RAGreedy::sampleMemoryUsage() {
+  if (!AreStatisticsEnabled())
+    return;
+  size_t Bytes = LIS->getVNInfoAllocator().getTotalMemory() +
+                 getLiveUnionMemory();
+  for (LiveIntervals::const_iterator I = LIS->begin(), E = LIS->end();
+       I != E; ++I) {
+    const LiveInterval &LI = *I->second;
+    Bytes += sizeof(LiveInterval) + heapBytes(LI.ranges) + heapBytes(LI.valnos);
+  }
+  unsigned KB = unsigned(std::min<uint64_t>(Bytes / 1024, ~0u));
+  if (KB > PeakMemoryKB)
+    PeakMemoryKB = KB;
+}
+
 unsigned RAGreedy::selectOrSplit(LiveInterval &VirtReg,
                                  SmallVectorImpl<LiveInterval*> &NewVRegs) {
+  NumSegments += VirtReg.ranges.size();
+  if ((++NumDequeued & 255) == 0)
+    sampleMemoryUsage();
+
   // Check if VirtReg is live across any calls.
   UsableRegs.clear();
   if (LIS->checkRegMaskInterference(VirtReg, UsableRegs))
@@ -1740,6 +1784,7 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   DomTree = &getAnalysis<MachineDominatorTree>();
   SpillerInstance.reset(createInlineSpiller(*this, *MF, *VRM));
   Loops = &getAnalysis<MachineLoopInfo>();
+  MBFI = &getAnalysis<MachineBlockFrequencyInfo>();
   Bundles = &getAnalysis<EdgeBundles>();
   SpillPlacer = &getAnalysis<SpillPlacement>();
   DebugVars = &getAnalysis<LiveDebugVariables>();
@@ -1751,8 +1796,52 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   NextCascade = 1;
   IntfCache.init(MF, &getLiveUnion(0), Indexes, LIS, TRI);
   GlobalCand.resize(32);  // This will grow as needed.
+  NumDequeued = 0;
 
   allocatePhysRegs();
+  sampleMemoryUsage();
+  reportDynamicSpillCost();
   releaseMemory();
   return true;
 }
+
+/// reportDynamicSpillCost - Add the spill code in MF to the weighted -stats
+/// counters.  Each access is weighted by the frequency of its block relative
+/// to the entry block, so unlike the static spill and reload counts these
+/// show whether the spill code landed in hot or cold blocks.
+void RAGreedy::reportDynamicSpillCost() {
+  if (!AreStatisticsEnabled())
+    return;
+
+  const MachineFrameInfo *MFrameInfo = MF->getFrameInfo();
+  const TargetInstrInfo *TII = MF->getTarget().getInstrInfo();
+  float SpillCost = 0, ReloadCost = 0;
+  for (MachineFunction::iterator MBB = MF->begin(), MBBE = MF->end();
+       MBB != MBBE; ++MBB) {
+    unsigned Spills = 0, Reloads = 0;
+    for (MachineBasicBlock::iterator MI = MBB->begin(), E = MBB->end();
+         MI != E; ++MI) {
+      // hasLoad/StoreToStackSlot also catch accesses folded into other
+      // instructions.
+      const MachineMemOperand *MMO;
+      int FI;
+      if (TII->hasLoadFromStackSlot(MI, MMO, FI) &&
+          MFrameInfo->isSpillSlotObjectIndex(FI))
+        ++Reloads;
+      if (TII->hasStoreToStackSlot(MI, MMO, FI) &&
+          MFrameInfo->isSpillSlotObjectIndex(FI))
+        ++Spills;
+    }
+    if (!Spills && !Reloads)
+      continue;
+    float Weight = float(MBFI->getBlockFreq(MBB).getFrequency()) /
+                   BlockFrequency::getEntryFrequency();
+    SpillCost += Spills * Weight;
+    ReloadCost += Reloads * Weight;
+  }
+
+  // Deep loop nests have huge frequencies; keep the counters from wrapping.
+  const float Limit = 1e9f;
+  NumDynSpills += unsigned(std::min(SpillCost, Limit) + 0.5f);
+  NumDynReloads += unsigned(std::min(ReloadCost, Limit) + 0.5f);
+}
@@ -23,21 +23,33 @@
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Pass.h"
 #include "llvm/Target/TargetData.h"
 #include "llvm/Target/TargetLowering.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <cstring>
 using namespace llvm;
 
+STATISTIC(NodesVisited    , "Number of dag nodes visited by the combiner");
 STATISTIC(NodesCombined   , "Number of dag nodes combined");
+STATISTIC(TargetCombined  , "Number of dag nodes combined by the target");
+STATISTIC(NodesPromoted   , "Number of dag nodes promoted to a wider type");
+STATISTIC(CommutedCSE     , "Number of dag nodes CSE'd by commuting");
+STATISTIC(BudgetExhausted , "Number of combiner runs that hit the budget");
 STATISTIC(PreIndexedNodes , "Number of pre-indexed nodes created");
 STATISTIC(PostIndexedNodes, "Number of post-indexed nodes created");
 STATISTIC(OpsNarrowed     , "Number of load/op/store narrowed");
@@ -52,6 +64,11 @@ namespace {
     CombinerGlobalAA("combiner-global-alias-analysis", cl::Hidden,
                cl::desc("Include global information in alias analysis"));
 
+  static cl::opt<unsigned>
+    CombinerMaxVisits("combiner-max-visits", cl::Hidden, cl::init(0),
+               cl::desc("Stop combining a DAG after visiting this many nodes "
+                        "(0 = unlimited)"));
+
 //------------------------------ DAGCombiner ---------------------------------//
 
   class DAGCombiner {
@@ -69,18 +86,13 @@ namespace {
     // also only appear once. The naive approach to this takes
     // linear time.
     //
-    // To reduce the insert/remove time to logarithmic, we use
-    // a set and a vector to maintain our worklist.
-    //
-    // The set contains the items on the worklist, but does not
-    // maintain the order they should be visited.
-    //
-    // The vector maintains the order nodes should be visited, but may
-    // contain duplicate or removed nodes. When choosing a node to
-    // visit, we pop off the order stack until we find an item that is
-    // also in the contents set. All operations are O(log N).
-    SmallPtrSet<SDNode*, 64> WorkListContents;
-    SmallVector<SDNode*, 64> WorkListOrder;
+    // To make every operation constant time, WorkList holds the nodes in the
+    // order they should be visited and WorkListMap maps each node on the
+    // worklist to its index in WorkList.  Re-adding or removing a node nulls
+    // out its old slot instead of searching for it, and choosing a node to
+    // visit pops null slots off the back of WorkList.
+    SmallVector<SDNode*, 64> WorkList;
+    DenseMap<SDNode*, unsigned> WorkListMap;
 
     // AA - Used for DAG load/store alias analysis.
     AliasAnalysis &AA;
@@ -103,14 +115,36 @@ namespace {
     /// AddToWorkList - Add to the work list making sure its instance is at the
     /// back (next to be processed.)
     void AddToWorkList(SDNode *N) {
-      WorkListContents.insert(N);
-      WorkListOrder.push_back(N);
+      std::pair<DenseMap<SDNode*, unsigned>::iterator, bool> IP =
+        WorkListMap.insert(std::make_pair(N, WorkList.size()));
+      if (!IP.second) {
+        WorkList[IP.first->second] = 0;
+        IP.first->second = WorkList.size();
+      }
+      WorkList.push_back(N);
     }
 
     /// removeFromWorkList - remove all instances of N from the worklist.
     ///
     void removeFromWorkList(SDNode *N) {
-      WorkListContents.erase(N);
+      DenseMap<SDNode*, unsigned>::iterator I = WorkListMap.find(N);
+      if (I == WorkListMap.end())
+        return;
+      WorkList[I->second] = 0;
+      WorkListMap.erase(I);
+    }
+
+    /// getNextWorkListEntry - Remove and return the node that should be
+    /// visited next, or null if the worklist is empty.
+    SDNode *getNextWorkListEntry() {
+      while (!WorkList.empty()) {
+        SDNode *N = WorkList.pop_back_val();
+        if (N) {
+          WorkListMap.erase(N);
+          return N;
+        }
+      }
+      return 0;
     }
 
     SDValue CombineTo(SDNode *N, const SDValue *To, unsigned NumTo,
@@ -968,6 +1002,79 @@ bool DAGCombiner::PromoteLoad(SDValue Op) {
 }
 
 
+//===----------------------------------------------------------------------===//
+//  Per-opcode instrumentation
+//===----------------------------------------------------------------------===//
+//
+// Each opcode's visit routine is one family of combine rules.  With -stats the
+// combiner counts how often each family fires, and with -time-passes it times
+// each one.  Target-specific opcodes share a single entry.  A run gathers its
+// counts and times in a local CombineProfile and merges them into the global
+// counters and timers only when it is done, so the per-node cost is two reads
+// of a cheap clock.
+
+namespace {
+  /// CombineProfileEntry - The counts and time of one opcode in one run.
+  struct CombineProfileEntry {
+    std::string Name;
+    unsigned Combines;
+    uint64_t USec;
+
+    CombineProfileEntry() : Combines(0), USec(0) {}
+  };
+  typedef std::vector<CombineProfileEntry> CombineProfile;
+
+  const unsigned NumCombineProfileEntries = ISD::BUILTIN_OP_END + 1;
+
+  /// CombineTimers - The -time-passes timers of the profile entries.
+  struct CombineTimers {
+    TimerGroup TG;
+    Timer Timers[NumCombineProfileEntries];
+
+    CombineTimers() : TG("DAG Combiner") {}
+  };
+}
+
+static unsigned getCombineProfileIndex(const SDNode *N) {
+  return std::min(N->getOpcode(), unsigned(ISD::BUILTIN_OP_END));
+}
+
+// Like the STATISTICs above, the per-opcode counters live in static storage:
+// the statistics registry keeps pointers to them until it prints them.
+static Statistic CombinesByOpcode[NumCombineProfileEntries];
+static char CombinesByOpcodeDesc[NumCombineProfileEntries][64];
+
+static ManagedStatic<CombineTimers> TheCombineTimers;
+static ManagedStatic<sys::SmartMutex<true> > CombineProfileLock;
+
+/// mergeCombineProfile - Add the counts and times of one combiner run to the
+/// -stats counters and the -time-passes timers.
+static void mergeCombineProfile(const CombineProfile &Profile) {
+  sys::SmartScopedLock<true> Lock(*CombineProfileLock);
+  for (unsigned i = 0, e = Profile.size(); i != e; ++i) {
+    const CombineProfileEntry &E = Profile[i];
+    if (E.Name.empty())
+      continue;
+
+    if (E.Combines) {
+      if (!CombinesByOpcodeDesc[i][0]) {
+        std::string Desc = "Number of " + E.Name + " nodes combined";
+        std::strncpy(CombinesByOpcodeDesc[i], Desc.c_str(),
+                     sizeof(CombinesByOpcodeDesc[i]) - 1);
+        CombinesByOpcode[i].construct(DEBUG_TYPE, CombinesByOpcodeDesc[i]);
+      }
+      CombinesByOpcode[i] += E.Combines;
+    }
+
+    if (TimePassesIsEnabled) {
+      Timer &T = TheCombineTimers->Timers[i];
+      if (!T.isInitialized())
+        T.init(E.Name, TheCombineTimers->TG);
+      T.addWallTime(E.USec / 1000000.0);
+    }
+  }
+}
+
 //===----------------------------------------------------------------------===//
 //  Main DAG Combiner implementation
 //===----------------------------------------------------------------------===//
@@ -983,6 +1090,15 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
        E = DAG.allnodes_end(); I != E; ++I)
     AddToWorkList(I);
 
+  // Machine-generated code can make some combines ping-pong for a very long
+  // time, so optionally bound the number of nodes visited in one run.
+  unsigned Visits = 0;
+
+  // Only profile the combines if someone is going to look at the results.
+  CombineProfile Profile;
+  if (AreStatisticsEnabled() || TimePassesIsEnabled)
+    Profile.resize(NumCombineProfileEntries);
+
   // Create a dummy node (which is not added to allnodes), that adds a reference
   // to the root node, preventing it from being deleted, and tracking any
   // changes of the root.
@@ -994,15 +1110,15 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
 
   // while the worklist isn't empty, find a node and
   // try and combine it.
-  while (!WorkListContents.empty()) {
-    SDNode *N;
-    // The WorkListOrder holds the SDNodes in order, but it may contain duplicates.
-    // In order to avoid a linear scan, we use a set (O(log N)) to hold what the
-    // worklist *should* contain, and check the node we want to visit is should
-    // actually be visited.
-    do {
-      N = WorkListOrder.pop_back_val();
-    } while (!WorkListContents.erase(N));
+  while (SDNode *N = getNextWorkListEntry()) {
+    if (CombinerMaxVisits && ++Visits > CombinerMaxVisits) {
+      DEBUG(dbgs() << "\nDAG combiner budget of " << CombinerMaxVisits
+                   << " visits exhausted\n");
+      ++BudgetExhausted;
+      WorkList.clear();
+      WorkListMap.clear();
+      break;
+    }
 
     // If N has no uses, it is dead.  Make sure to revisit all N's operands once
     // N is deleted from the DAG, since they too may now be dead or may have a
@@ -1015,7 +1131,22 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
       continue;
     }
 
-    SDValue RV = combine(N);
+    ++NodesVisited;
+    SDValue RV;
+    if (Profile.empty()) {
+      RV = combine(N);
+    } else {
+      unsigned Idx = getCombineProfileIndex(N);
+      CombineProfileEntry &E = Profile[Idx];
+      if (E.Name.empty())
+        E.Name = Idx == ISD::BUILTIN_OP_END ? "target-specific"
+                                            : N->getOperationName(&DAG);
+      uint64_t Start = sys::TimeValue::now().usec();
+      RV = combine(N);
+      E.USec += sys::TimeValue::now().usec() - Start;
+      if (RV.getNode())
+        ++E.Combines;
+    }
 
     if (RV.getNode() == 0)
       continue;
@@ -1074,6 +1205,9 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
     }
   }
 
+  if (!Profile.empty())
+    mergeCombineProfile(Profile);
+
   // If the root changed (e.g. it was a dead load, update the root).
   DAG.setRoot(Dummy.getValue());
   DAG.RemoveDeadNodes();
@@ -1171,6 +1305,8 @@ SDValue DAGCombiner::combine(SDNode *N) {
         DagCombineInfo(DAG, !LegalTypes, !LegalOperations, false, this);
 
       RV = TLI.PerformDAGCombine(N, DagCombineInfo);
+      if (RV.getNode())
+        ++TargetCombined;
     }
   }
 
@@ -1201,6 +1337,8 @@ SDValue DAGCombiner::combine(SDNode *N) {
         RV = SDValue(N, 0);
       break;
     }
+    if (RV.getNode())
+      ++NodesPromoted;
   }
 
   // If N is a commutative binary node, try commuting it to enable more
@@ -1216,8 +1354,10 @@ SDValue DAGCombiner::combine(SDNode *N) {
       SDValue Ops[] = { N1, N0 };
       SDNode *CSENode = DAG.getNodeIfExists(N->getOpcode(), N->getVTList(),
                                             Ops, 2);
-      if (CSENode)
+      if (CSENode) {
+        ++CommutedCSE;
         return SDValue(CSENode, 0);
+      }
     }
   }
 
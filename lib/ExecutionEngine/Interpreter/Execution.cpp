@@ -19,6 +19,7 @@
 #include "llvm/CodeGen/IntrinsicLowering.h"
 #include "llvm/Support/GetElementPtrTypeIterator.h"
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
@@ -37,7 +38,7 @@ static cl::opt<bool> PrintVolatile("interpreter-print-volatile", cl::Hidden,
 //                     Various Helper Functions
 //===----------------------------------------------------------------------===//
 
-static void SetValue(Value *V, GenericValue Val, ExecutionContext &SF) {
+static void SetValue(Value *V, const GenericValue &Val, ExecutionContext &SF) {
   SF.Values[V] = Val;
 }
 
@@ -574,6 +575,7 @@ void Interpreter::exitCalled(GenericValue GV) {
   // the stack before interpreting atexit handlers.
   ECStack.clear();
   runAtExitHandlers();
+  flushDynamicInstCount();
   exit(GV.IntVal.zextOrTrunc(32).getZExtValue());
 }
 
@@ -695,7 +697,7 @@ void Interpreter::SwitchToNewBasicBlock(BasicBlock *Dest, ExecutionContext &SF){
   if (!isa<PHINode>(SF.CurInst)) return;  // Nothing fancy to do
 
   // Loop over all of the PHI nodes in the current block, reading their inputs.
-  std::vector<GenericValue> ResultValues;
+  SmallVector<GenericValue, 8> ResultValues;
 
   for (; PHINode *PN = dyn_cast<PHINode>(SF.CurInst); ++SF.CurInst) {
     // Search for the value corresponding to this previous bb...
@@ -1248,15 +1250,14 @@ GenericValue Interpreter::getConstantExprValue (ConstantExpr *CE,
 }
 
 GenericValue Interpreter::getOperandValue(Value *V, ExecutionContext &SF) {
-  if (ConstantExpr *CE = dyn_cast<ConstantExpr>(V)) {
-    return getConstantExprValue(CE, SF);
-  } else if (Constant *CPV = dyn_cast<Constant>(V)) {
-    return getConstantValue(CPV);
-  } else if (GlobalValue *GV = dyn_cast<GlobalValue>(V)) {
-    return PTOGV(getPointerToGlobal(GV));
-  } else {
+  // Most operands are the results of other instructions or arguments, so look
+  // those up before trying the various kinds of constants.
+  if (!isa<Constant>(V))
     return SF.Values[V];
-  }
+
+  if (ConstantExpr *CE = dyn_cast<ConstantExpr>(V))
+    return getConstantExprValue(CE, SF);
+  return getConstantValue(cast<Constant>(V));
 }
 
 //===----------------------------------------------------------------------===//
@@ -1310,8 +1311,10 @@ void Interpreter::run() {
     ExecutionContext &SF = ECStack.back();  // Current stack frame
     Instruction &I = *SF.CurInst++;         // Increment before execute
 
-    // Track the number of dynamic instructions executed.
-    ++NumDynamicInsts;
+    // Track the number of dynamic instructions executed.  Bumping the
+    // statistic itself is an atomic operation, which is too expensive to do
+    // for every instruction.
+    ++NumInstsExecuted;
 
     DEBUG(dbgs() << "About to interpret: " << I);
     visit(I);   // Dispatch to one of the visit* methods...
@@ -1338,4 +1341,10 @@ DEBUG(
     });
 #endif
   }
+  flushDynamicInstCount();
+}
+
+void Interpreter::flushDynamicInstCount() {
+  NumDynamicInsts += NumInstsExecuted;
+  NumInstsExecuted = 0;
 }
@@ -45,7 +45,7 @@ ExecutionEngine *Interpreter::create(Module *M, std::string* ErrStr) {
 // Interpreter ctor - Initialize stuff
 //
 Interpreter::Interpreter(Module *M)
-  : ExecutionEngine(M), TD(M) {
+  : ExecutionEngine(M), TD(M), NumInstsExecuted(0) {
       
   memset(&ExitValue.Untyped, 0, sizeof(ExitValue.Untyped));
   setTargetData(&TD);
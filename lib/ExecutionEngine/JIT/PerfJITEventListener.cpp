@@ -0,0 +1,131 @@
+//===-- PerfJITEventListener.cpp - Tell Linux perf about JITted code ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a JITEventListener object that writes a perf map file,
+// which the Linux perf tool reads to symbolize samples in JITted code.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Config/config.h"
+#include "llvm/ExecutionEngine/JITEventListener.h"
+
+#define DEBUG_TYPE "perf-jit-event-listener"
+#include "llvm/Function.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+
+namespace {
+
+// Buffered entries are written out at least this often, in seconds, while
+// the JIT keeps emitting functions.
+const sys::TimeValue::SecondsType FlushInterval = 1;
+
+sys::TimeValue getNextFlush(const sys::TimeValue &Now) {
+  return Now + sys::TimeValue(FlushInterval);
+}
+
+class PerfJITEventListener : public JITEventListener {
+  OwningPtr<raw_ostream> OwnedOS;
+  raw_ostream &OS;
+  bool FlushEachEntry;
+
+  /// NextFlush - When to write out the buffered entries, if the buffer has
+  /// not filled up before.
+  sys::TimeValue NextFlush;
+
+public:
+  PerfJITEventListener(raw_ostream &Out, bool FlushEachEntry)
+    : OS(Out), FlushEachEntry(FlushEachEntry),
+      NextFlush(getNextFlush(sys::TimeValue::now())) {}
+
+  /// Take ownership of a stream opened by the listener itself.
+  PerfJITEventListener(raw_fd_ostream *Out, bool FlushEachEntry)
+    : OwnedOS(Out), OS(*Out), FlushEachEntry(FlushEachEntry),
+      NextFlush(getNextFlush(sys::TimeValue::now())) {}
+
+  ~PerfJITEventListener();
+
+  virtual void NotifyFunctionEmitted(const Function &F,
+                                void *FnStart, size_t FnSize,
+                                const JITEvent_EmittedFunctionDetails &Details);
+};
+
+PerfJITEventListener::~PerfJITEventListener() {
+  OS.flush();
+}
+
+// Appends "<start> <size> <name>" to the map, with both numbers in hex.
+//
+// Entries are buffered, so a burst of emitted functions costs one write() per
+// buffer rather than one per function.  The buffer is written out when it
+// fills up, at least every FlushInterval seconds while entries keep arriving,
+// and when the listener is destroyed.  perf top reads the map
+// while the process is running and a crashed process never flushes its
+// buffer, so FlushEachEntry writes every entry out immediately instead.
+//
+// There is nothing to do when machine code is freed: the format cannot retire
+// an entry, so stale ones stay in the map.
+void PerfJITEventListener::NotifyFunctionEmitted(
+    const Function &F, void *FnStart, size_t FnSize,
+    const JITEvent_EmittedFunctionDetails &) {
+  OS.write_hex(reinterpret_cast<uintptr_t>(FnStart)) << ' ';
+  OS.write_hex(FnSize) << ' ';
+  if (F.hasName())
+    OS << F.getName();
+  else
+    OS << "<unnamed>";
+  OS << '\n';
+
+  if (FlushEachEntry) {
+    OS.flush();
+    return;
+  }
+  sys::TimeValue Now = sys::TimeValue::now();
+  if (Now >= NextFlush) {
+    OS.flush();
+    NextFlush = getNextFlush(Now);
+  }
+}
+
+}  // anonymous namespace.
+
+namespace llvm {
+JITEventListener *JITEventListener::createPerfJITEventListener(
+                                      bool FlushEachEntry) {
+#ifdef HAVE_UNISTD_H
+  std::string Path = "/tmp/perf-" + utostr(::getpid()) + ".map";
+  std::string ErrorInfo;
+  OwningPtr<raw_fd_ostream> Out(new raw_fd_ostream(Path.c_str(), ErrorInfo));
+  if (!ErrorInfo.empty()) {
+    DEBUG(dbgs() << "Failed to open " << Path << ": " << ErrorInfo << "\n");
+    return 0;
+  }
+  Out->SetBufferSize(64 * 1024);
+  return new PerfJITEventListener(Out.take(), FlushEachEntry);
+#else
+  return 0;
+#endif
+}
+
+// for testing
+JITEventListener *JITEventListener::createPerfJITEventListener(
+                                      raw_ostream &OS, bool FlushEachEntry) {
+  return new PerfJITEventListener(OS, FlushEachEntry);
+}
+
+} // namespace llvm
@@ -11,13 +11,19 @@
 #include "MCJITMemoryManager.h"
 #include "llvm/DerivedTypes.h"
 #include "llvm/Function.h"
+#include "llvm/Module.h"
+#include "llvm/PassManager.h"
 #include "llvm/ExecutionEngine/GenericValue.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
 #include "llvm/ExecutionEngine/JITMemoryManager.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/DynamicLibrary.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetData.h"
 
 using namespace llvm;
@@ -53,39 +59,143 @@ ExecutionEngine *MCJIT::createJIT(Module *M,
 }
 
 MCJIT::MCJIT(Module *m, TargetMachine *tm, TargetJITInfo &tji,
-             RTDyldMemoryManager *MM, bool AllocateGVsWithCode)
-  : ExecutionEngine(m), TM(tm), MemMgr(MM), M(m), OS(Buffer), Dyld(MM) {
-
+             MCJITMemoryManager *MM, bool AllocateGVsWithCode)
+  : ExecutionEngine(m), TM(tm), MemMgr(MM), Dyld(MM), ObjCache(0) {
   setTargetData(TM->getTargetData());
-  PM.add(new TargetData(*TM->getTargetData()));
+  indexDefinitions(m);
+
+  // Code generation itself is deferred to emitObject(), so that clients
+  // get the chance to add more modules and to install an object cache first.
+}
+
+MCJIT::~MCJIT() {
+  delete MemMgr;
+  delete TM;
+}
+
+static bool isExportedDefinition(const GlobalValue &GV) {
+  return !GV.isDeclaration() && !GV.hasLocalLinkage() &&
+         !GV.hasAvailableExternallyLinkage();
+}
+
+void MCJIT::indexDefinitions(Module *M) {
+  // GetOrCreateValue leaves existing entries alone, so earlier modules win.
+  for (Module::iterator I = M->begin(), E = M->end(); I != E; ++I)
+    if (isExportedDefinition(*I))
+      DefiningModules.GetOrCreateValue(I->getName(), M);
+  for (Module::global_iterator I = M->global_begin(), E = M->global_end();
+       I != E; ++I)
+    if (isExportedDefinition(*I))
+      DefiningModules.GetOrCreateValue(I->getName(), M);
+  for (Module::alias_iterator I = M->alias_begin(), E = M->alias_end();
+       I != E; ++I)
+    if (isExportedDefinition(*I))
+      DefiningModules.GetOrCreateValue(I->getName(), M);
+}
+
+void MCJIT::addModule(Module *M) {
+  ExecutionEngine::addModule(M);
+  indexDefinitions(M);
+}
+
+bool MCJIT::removeModule(Module *M) {
+  if (!ExecutionEngine::removeModule(M))
+    return false;
+  EmittedModules.erase(M);
+
+  // Drop M's names, and let the remaining modules claim the ones they define
+  // too.
+  bool Dropped = false;
+  for (StringMap<Module*>::iterator I = DefiningModules.begin(),
+         E = DefiningModules.end(); I != E; ) {
+    StringMap<Module*>::iterator Cur = I;
+    ++I;
+    if (Cur->second == M) {
+      DefiningModules.erase(Cur);
+      Dropped = true;
+    }
+  }
+  if (Dropped)
+    for (unsigned i = 0, e = Modules.size(); i != e; ++i)
+      indexDefinitions(Modules[i]);
+  return true;
+}
 
-  // Turn the machine code intermediate representation into bytes in memory
-  // that may be executed.
-  if (TM->addPassesToEmitMC(PM, Ctx, OS, false)) {
-    report_fatal_error("Target does not support MC emission!");
+void MCJIT::emitModule(Module *M) {
+  MemoryBuffer *MB = 0;
+  if (ObjCache) {
+    // The dynamic linker patches section addresses into the object in place,
+    // and caches typically hand back a read-only mapping of a file, so this
+    // is the one copy a cached object needs.
+    OwningPtr<MemoryBuffer> Cached(ObjCache->getObject(M));
+    if (Cached)
+      MB = MemoryBuffer::getMemBufferCopy(Cached->getBuffer());
   }
 
-  // Initialize passes.
-  // FIXME: When we support multiple modules, we'll want to move the code
-  // gen and finalization out of the constructor here and do it more
-  // on-demand as part of getPointerToFunction().
-  PM.run(*M);
-  // Flush the output buffer so the SmallVector gets its data.
-  OS.flush();
-
-  // Load the object into the dynamic linker.
-  MemoryBuffer *MB = MemoryBuffer::getMemBuffer(StringRef(Buffer.data(),
-                                                          Buffer.size()),
-                                                "", false);
+  if (!MB) {
+    SmallVector<char, 4096> Buffer; // Working buffer into which we JIT.
+    raw_svector_ostream OS(Buffer);
+
+    PassManager PM;
+    PM.add(new TargetData(*TM->getTargetData()));
+
+    // Turn the machine code intermediate representation into bytes in memory
+    // that may be executed.
+    MCContext *Ctx;
+    if (TM->addPassesToEmitMC(PM, Ctx, OS, false))
+      report_fatal_error("Target does not support MC emission!");
+
+    PM.run(*M);
+    // Flush the output buffer so the SmallVector gets its data.
+    OS.flush();
+
+    MB = MemoryBuffer::getMemBufferCopy(StringRef(Buffer.data(),
+                                                  Buffer.size()));
+    if (ObjCache)
+      ObjCache->notifyObjectCompiled(M, MB);
+  }
+
+  // Load the object into the dynamic linker, which takes ownership of it.
   if (Dyld.loadObject(MB))
     report_fatal_error(Dyld.getErrorString());
-  // Resolve any relocations.
+}
+
+void MCJIT::emitObject(Module *M) {
+  if (!EmittedModules.insert(M))
+    return;
+
+  // The relocations of a module can only be resolved once the modules that
+  // define the symbols it refers to are loaded as well, so emit all of them
+  // now.  Modules that are not reachable this way stay unemitted.
+  SmallVector<Module*, 4> Worklist;
+  Worklist.push_back(M);
+  while (!Worklist.empty()) {
+    Module *Cur = Worklist.pop_back_val();
+    emitModule(Cur);
+
+    for (Module::iterator I = Cur->begin(), E = Cur->end(); I != E; ++I)
+      if (I->isDeclaration() || I->hasAvailableExternallyLinkage())
+        if (Module *Def = findDefiningModule(I->getName()))
+          if (EmittedModules.insert(Def))
+            Worklist.push_back(Def);
+    for (Module::global_iterator I = Cur->global_begin(),
+           E = Cur->global_end(); I != E; ++I)
+      if (I->isDeclaration() || I->hasAvailableExternallyLinkage())
+        if (Module *Def = findDefiningModule(I->getName()))
+          if (EmittedModules.insert(Def))
+            Worklist.push_back(Def);
+  }
+
+  // Resolve any relocations.  Only the objects just loaded are written to,
+  // so code emitted earlier can keep running meanwhile.
   Dyld.resolveRelocations();
+
+  MemMgr->finalizeMemory();
 }
 
-MCJIT::~MCJIT() {
-  delete MemMgr;
-  delete TM;
+void MCJIT::finalizeObject() {
+  for (unsigned i = 0, e = Modules.size(); i != e; ++i)
+    emitObject(Modules[i]);
 }
 
 void *MCJIT::getPointerToBasicBlock(BasicBlock *BB) {
@@ -94,12 +204,19 @@ void *MCJIT::getPointerToBasicBlock(BasicBlock *BB) {
 
 void *MCJIT::getPointerToFunction(Function *F) {
   if (F->isDeclaration() || F->hasAvailableExternallyLinkage()) {
+    // The definition may live in another module.
+    if (Module *Def = findDefiningModule(F->getName()))
+      if (Function *DefF = Def->getFunction(F->getName()))
+        return getPointerToFunction(DefF);
+
     bool AbortOnFailure = !F->hasExternalWeakLinkage();
     void *Addr = getPointerToNamedFunction(F->getName(), AbortOnFailure);
     addGlobalMapping(F, Addr);
     return Addr;
   }
 
+  emitObject(F->getParent());
+
   // FIXME: Should we be using the mangler for this? Probably.
   StringRef BaseName = F->getName();
   if (BaseName[0] == '\1')
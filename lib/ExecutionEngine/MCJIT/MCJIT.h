@@ -10,42 +10,72 @@
 #ifndef LLVM_LIB_EXECUTIONENGINE_MCJIT_H
 #define LLVM_LIB_EXECUTIONENGINE_MCJIT_H
 
-#include "llvm/PassManager.h"
+#include "MCJITMemoryManager.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/RuntimeDyld.h"
-#include "llvm/ADT/SmallVector.h"
-#include "llvm/Support/raw_ostream.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringMap.h"
 
 namespace llvm {
 
 // FIXME: This makes all kinds of horrible assumptions for the time being,
-// like only having one module, not needing to worry about multi-threading,
-// blah blah. Purely in get-it-up-and-limping mode for now.
+// like not needing to worry about multi-threading, blah blah. Purely in
+// get-it-up-and-limping mode for now.
 
 class MCJIT : public ExecutionEngine {
   MCJIT(Module *M, TargetMachine *tm, TargetJITInfo &tji,
-        RTDyldMemoryManager *MemMgr, bool AllocateGVsWithCode);
+        MCJITMemoryManager *MemMgr, bool AllocateGVsWithCode);
 
   TargetMachine *TM;
-  MCContext *Ctx;
-  RTDyldMemoryManager *MemMgr;
-
-  // FIXME: These may need moved to a separate 'jitstate' member like the
-  // non-MC JIT does for multithreading and such. Just keep them here for now.
-  PassManager PM;
-  Module *M;
-  // FIXME: This really doesn't belong here.
-  SmallVector<char, 4096> Buffer; // Working buffer into which we JIT.
-  raw_svector_ostream OS;
+  MCJITMemoryManager *MemMgr;
 
   RuntimeDyld Dyld;
 
+  ObjectCache *ObjCache;
+
+  /// EmittedModules - The modules whose objects have been loaded into the
+  /// dynamic linker.  The others are compiled the first time one of their
+  /// symbols is needed.
+  SmallPtrSet<Module*, 4> EmittedModules;
+
+  /// DefiningModules - Maps the name of each global defined by one of the
+  /// modules to that module.  If several modules define a name, the one added
+  /// first wins.
+  StringMap<Module*> DefiningModules;
+
+  /// indexDefinitions - Add the globals M defines to DefiningModules.
+  void indexDefinitions(Module *M);
+
+  /// findDefiningModule - Return the module that defines the global named
+  /// Name, or null if none of the modules does.
+  Module *findDefiningModule(StringRef Name) const {
+    StringMap<Module*>::const_iterator I = DefiningModules.find(Name);
+    return I == DefiningModules.end() ? 0 : I->second;
+  }
+
+  /// emitModule - Generate the object file for M, or fetch it from the object
+  /// cache, and load it into the dynamic linker.
+  void emitModule(Module *M);
+
+  /// emitObject - Make sure M has been emitted, along with every module that
+  /// defines a symbol M refers to, and resolve their relocations.  Does
+  /// nothing if M has been emitted already.
+  void emitObject(Module *M);
+
 public:
   ~MCJIT();
 
   /// @name ExecutionEngine interface implementation
   /// @{
 
+  /// addModule - Add a module.  Its code is generated the first time one of
+  /// its symbols is needed, so globals must be added to it before then.
+  virtual void addModule(Module *M);
+
+  /// removeModule - Remove a module.  Code that has been generated for it
+  /// stays loaded.
+  virtual bool removeModule(Module *M);
+
   virtual void *getPointerToBasicBlock(BasicBlock *BB);
 
   virtual void *getPointerToFunction(Function *F);
@@ -76,6 +106,14 @@ public:
     Dyld.mapSectionAddress(LocalAddress, TargetAddress);
   }
 
+  virtual void setObjectCache(ObjectCache *Cache) {
+    assert(EmittedModules.empty() && "Object cache set after code generation!");
+    ObjCache = Cache;
+  }
+
+  /// finalizeObject - Emit every module that has not been emitted yet.
+  virtual void finalizeObject();
+
   /// @}
   /// @name (Private) Registration Interfaces
   /// @{
@@ -13,6 +13,7 @@
 #include "llvm/Module.h"
 #include "llvm/ExecutionEngine/JITMemoryManager.h"
 #include "llvm/ExecutionEngine/RuntimeDyld.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include <assert.h>
 
 namespace llvm {
@@ -26,7 +27,7 @@ class MCJITMemoryManager : public RTDyldMemoryManager {
 
 public:
   MCJITMemoryManager(JITMemoryManager *jmm) :
-    JMM(jmm?jmm:JITMemoryManager::CreateDefaultMemManager()) {}
+    JMM(jmm?jmm:new SectionMemoryManager()) {}
 
   uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment,
                                unsigned SectionID) {
@@ -43,6 +44,10 @@ public:
     return JMM->getPointerToNamedFunction(Name, AbortOnFailure);
   }
 
+  /// finalizeMemory - Prepare the code that has just been loaded to run.
+  void finalizeMemory() {
+    JMM->finalizeMemory();
+  }
 };
 
 } // End llvm namespace
@@ -0,0 +1,14 @@
+//===-- ObjectCache.cpp - Out-of-line members of ObjectCache --------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+
+using namespace llvm;
+
+ObjectCache::~ObjectCache() {}
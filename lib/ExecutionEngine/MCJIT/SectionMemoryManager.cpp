@@ -0,0 +1,184 @@
+//===- SectionMemoryManager.cpp - Memory manager for MCJIT/RtDyld *- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the section-based memory manager used by the MCJIT
+// execution engine.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/Process.h"
+#include <algorithm>
+
+#ifdef __linux__
+// These includes used by SectionMemoryManager::getPointerToNamedFunction()
+// for Glibc trickery. Look comments in this function for more information.
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+
+SectionMemoryManager::SectionMemoryManager(size_t SlabSize, bool UseHugePages)
+  : SlabSize(SlabSize), UseHugePages(UseHugePages) {}
+
+SectionMemoryManager::~SectionMemoryManager() {
+  for (unsigned i = 0, e = CodeMem.Slabs.size(); i != e; ++i)
+    sys::Memory::releaseMappedMemory(CodeMem.Slabs[i]);
+  for (unsigned i = 0, e = DataMem.Slabs.size(); i != e; ++i)
+    sys::Memory::releaseMappedMemory(DataMem.Slabs[i]);
+}
+
+uint8_t *SectionMemoryManager::allocateSection(MemoryGroup &Group,
+                                               uintptr_t Size,
+                                               unsigned Alignment,
+                                               unsigned Flags) {
+  if (!Alignment)
+    Alignment = 16;
+  assert(!(Alignment & (Alignment - 1)) && "Alignment must be a power of two");
+
+  uintptr_t Addr = (Group.Cur + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+  if (!Group.Cur || Addr + Size > Group.End) {
+    uintptr_t Needed = Size + Alignment;
+    sys::MemoryBlock MB =
+      sys::Memory::allocateMappedMemory(std::max<uintptr_t>(SlabSize, Needed),
+                                        Flags);
+    if (!MB.base())
+      return 0;
+    Group.Slabs.push_back(MB);
+
+    uintptr_t Start = (uintptr_t)MB.base();
+    Addr = (Start + Alignment - 1) & ~(uintptr_t)(Alignment - 1);
+    // A section too large for a regular slab gets a slab of its own, and the
+    // tail of the current slab stays available for later sections.
+    if (Needed <= SlabSize || !Group.Cur) {
+      Group.Cur = Addr + Size;
+      Group.End = Start + MB.size();
+    }
+  } else {
+    Group.Cur = Addr + Size;
+  }
+
+  Group.BytesUsed += Size;
+  return (uint8_t*)Addr;
+}
+
+uint8_t *SectionMemoryManager::allocateCodeSection(uintptr_t Size,
+                                                   unsigned Alignment,
+                                                   unsigned SectionID) {
+  unsigned Flags = sys::Memory::MF_READ | sys::Memory::MF_WRITE;
+  if (UseHugePages)
+    Flags |= sys::Memory::MF_HUGE_PAGES;
+  uint8_t *Addr = allocateSection(CodeMem, Size, Alignment, Flags);
+  if (!Addr)
+    return 0;
+
+  uintptr_t PageSize = sys::Process::GetPageSize();
+  uintptr_t Start = (uintptr_t)Addr & ~(PageSize - 1);
+  uintptr_t End = ((uintptr_t)Addr + Size + PageSize - 1) & ~(PageSize - 1);
+  PendingCode.push_back(sys::MemoryBlock((void*)Start, End - Start));
+  return Addr;
+}
+
+uint8_t *SectionMemoryManager::allocateDataSection(uintptr_t Size,
+                                                   unsigned Alignment,
+                                                   unsigned SectionID) {
+  return allocateSection(DataMem, Size, Alignment,
+                         sys::Memory::MF_READ | sys::Memory::MF_WRITE);
+}
+
+void SectionMemoryManager::finalizeMemory() {
+  if (PendingCode.empty())
+    return;
+
+  // protectMappedMemory also invalidates the instruction cache.
+  for (unsigned i = 0, e = PendingCode.size(); i != e; ++i) {
+    std::string ErrMsg;
+    if (sys::Memory::protectMappedMemory(PendingCode[i],
+                                         sys::Memory::MF_READ |
+                                         sys::Memory::MF_EXEC, &ErrMsg))
+      report_fatal_error("Unable to change JIT memory protection: " + ErrMsg);
+  }
+  PendingCode.clear();
+
+  // The page the next section would start in may just have become read-only,
+  // so move on to the next page.
+  uintptr_t PageSize = sys::Process::GetPageSize();
+  CodeMem.Cur = std::min((CodeMem.Cur + PageSize - 1) & ~(PageSize - 1),
+                         CodeMem.End);
+}
+
+void SectionMemoryManager::invalidateInstructionCache() {
+  for (unsigned i = 0, e = CodeMem.Slabs.size(); i != e; ++i)
+    sys::Memory::InvalidateInstructionCache(CodeMem.Slabs[i].base(),
+                                            CodeMem.Slabs[i].size());
+}
+
+size_t SectionMemoryManager::getReservedBytes(const MemoryGroup &Group) {
+  size_t Bytes = 0;
+  for (unsigned i = 0, e = Group.Slabs.size(); i != e; ++i)
+    Bytes += Group.Slabs[i].size();
+  return Bytes;
+}
+
+SectionMemoryManager::MemoryUsage
+SectionMemoryManager::getMemoryUsage() const {
+  MemoryUsage Usage;
+  Usage.CodeBytesReserved = getReservedBytes(CodeMem);
+  Usage.CodeBytesUsed = CodeMem.BytesUsed;
+  Usage.DataBytesReserved = getReservedBytes(DataMem);
+  Usage.DataBytesUsed = DataMem.BytesUsed;
+  Usage.NumCodeSlabs = CodeMem.Slabs.size();
+  Usage.NumDataSlabs = DataMem.Slabs.size();
+  return Usage;
+}
+
+void *SectionMemoryManager::getPointerToNamedFunction(const std::string &Name,
+                                                      bool AbortOnFailure) {
+#if defined(__linux__)
+  //===--------------------------------------------------------------------===//
+  // Function stubs that are invoked instead of certain library calls
+  //
+  // Force the following functions to be linked in to anything that uses the
+  // JIT. This is a hack designed to work around the all-too-clever Glibc
+  // strategy of making these functions work differently when inlined vs. when
+  // not inlined, and hiding their real definitions in a separate archive file
+  // that the dynamic linker can't see. For more info, search for
+  // 'libc_nonshared.a' on Google, or read http://llvm.org/PR274.
+  if (Name == "stat") return (void*)(intptr_t)&stat;
+  if (Name == "fstat") return (void*)(intptr_t)&fstat;
+  if (Name == "lstat") return (void*)(intptr_t)&lstat;
+  if (Name == "stat64") return (void*)(intptr_t)&stat64;
+  if (Name == "fstat64") return (void*)(intptr_t)&fstat64;
+  if (Name == "lstat64") return (void*)(intptr_t)&lstat64;
+  if (Name == "atexit") return (void*)(intptr_t)&atexit;
+  if (Name == "mknod") return (void*)(intptr_t)&mknod;
+#endif // __linux__
+
+  const char *NameStr = Name.c_str();
+  void *Ptr = sys::DynamicLibrary::SearchForAddressOfSymbol(NameStr);
+  if (Ptr) return Ptr;
+
+  // If it wasn't found and if it starts with an underscore ('_') character,
+  // try again without the underscore.
+  if (NameStr[0] == '_') {
+    Ptr = sys::DynamicLibrary::SearchForAddressOfSymbol(NameStr+1);
+    if (Ptr) return Ptr;
+  }
+
+  if (AbortOnFailure)
+    report_fatal_error("Program used external function '" + Name +
+                      "' which could not be resolved!");
+  return 0;
+}
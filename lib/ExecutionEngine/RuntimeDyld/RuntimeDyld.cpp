@@ -36,16 +36,24 @@ namespace {
   }
 } // end anonymous namespace
 
-// Resolve the relocations for all symbols we currently know about.
+// Resolve the relocations that have not been resolved yet.  Relocations that
+// have been resolved are only re-resolved when a section is remapped.
 void RuntimeDyldImpl::resolveRelocations() {
   // First, resolve relocations associated with external symbols.
   resolveExternalSymbols();
 
-  // Just iterate over the sections we have and resolve all the relocations
-  // in them. Gross overkill, but it gets the job done.
   for (int i = 0, e = Sections.size(); i != e; ++i) {
-    reassignSectionAddress(i, Sections[i].LoadAddress);
+    DenseMap<unsigned, RelocationList>::iterator I = Relocations.find(i);
+    if (I == Relocations.end())
+      continue;
+    DEBUG(dbgs() << "Resolving relocations Section #" << i
+            << "\t" << format("%p", (uint8_t *)Sections[i].LoadAddress)
+            << "\n");
+    resolveRelocationList(I->second, Sections[i].LoadAddress);
+    RelocationList &Resolved = ResolvedRelocations[i];
+    Resolved.append(I->second.begin(), I->second.end());
   }
+  Relocations.clear();
 }
 
 void RuntimeDyldImpl::mapSectionAddress(void *LocalAddress,
@@ -344,14 +352,17 @@ uint8_t *RuntimeDyldImpl::createStubFunction(uint8_t *Addr) {
     return Addr;
 }
 
-// Assign an address to a symbol name and resolve all the relocations
-// associated with it.
+// Assign an address to a section and re-resolve the relocations that have
+// already been resolved against it or within it.
 void RuntimeDyldImpl::reassignSectionAddress(unsigned SectionID,
                                              uint64_t Addr) {
   // The address to use for relocation resolution is not
   // the address of the local section buffer. We must be doing
   // a remote execution environment of some sort. Re-apply any
-  // relocations referencing this section with the given address.
+  // relocations referencing this section with the given address, and any
+  // relocations within it, since PC-relative ones depend on where it is.
+  // Relocations that have not been resolved yet pick the address up when
+  // they are.
   //
   // Addr is a uint64_t because we can't assume the pointer width
   // of the target is the same as that of the host. Just use a generic
@@ -360,7 +371,23 @@ void RuntimeDyldImpl::reassignSectionAddress(unsigned SectionID,
   DEBUG(dbgs() << "Resolving relocations Section #" << SectionID
           << "\t" << format("%p", (uint8_t *)Addr)
           << "\n");
-  resolveRelocationList(Relocations[SectionID], Addr);
+  for (DenseMap<unsigned, RelocationList>::iterator
+         I = ResolvedRelocations.begin(), E = ResolvedRelocations.end();
+       I != E; ++I) {
+    const RelocationList &Relocs = I->second;
+    uint64_t Value = Sections[I->first].LoadAddress;
+    for (unsigned i = 0, e = Relocs.size(); i != e; ++i)
+      if (I->first == SectionID || Relocs[i].SectionID == SectionID)
+        resolveRelocationEntry(Relocs[i], Value);
+  }
+  for (StringMap<ResolvedSymbol>::iterator
+         I = ResolvedExternalSymbols.begin(), E = ResolvedExternalSymbols.end();
+       I != E; ++I) {
+    const RelocationList &Relocs = I->second.second;
+    for (unsigned i = 0, e = Relocs.size(); i != e; ++i)
+      if (Relocs[i].SectionID == SectionID)
+        resolveRelocationEntry(Relocs[i], I->second.first);
+  }
 }
 
 void RuntimeDyldImpl::resolveRelocationEntry(const RelocationEntry &RE,
@@ -389,9 +416,11 @@ void RuntimeDyldImpl::resolveRelocationList(const RelocationList &Relocs,
 void RuntimeDyldImpl::resolveExternalSymbols() {
   StringMap<RelocationList>::iterator i = ExternalSymbolRelocations.begin(),
                                       e = ExternalSymbolRelocations.end();
-  for (; i != e; i++) {
-    StringRef Name = i->first();
-    RelocationList &Relocs = i->second;
+  while (i != e) {
+    StringMap<RelocationList>::iterator Cur = i;
+    ++i;
+    StringRef Name = Cur->first();
+    RelocationList &Relocs = Cur->second;
     SymbolTableMap::const_iterator Loc = GlobalSymbolTable.find(Name);
     if (Loc == GlobalSymbolTable.end()) {
       // This is an external symbol, try to get it address from
@@ -402,8 +431,19 @@ void RuntimeDyldImpl::resolveExternalSymbols() {
               << "\t" << format("%p", Addr)
               << "\n");
       resolveRelocationList(Relocs, (uintptr_t)Addr);
+      ResolvedSymbol &Resolved = ResolvedExternalSymbols[Name];
+      Resolved.first = (uintptr_t)Addr;
+      Resolved.second.append(Relocs.begin(), Relocs.end());
+      ExternalSymbolRelocations.erase(Cur);
     } else {
-      report_fatal_error("Expected external symbol");
+      // The symbol is defined by an object that was loaded after the one
+      // referring to it.  From now on these are ordinary section relocations.
+      for (unsigned j = 0, je = Relocs.size(); j != je; ++j) {
+        RelocationEntry RECopy = Relocs[j];
+        RECopy.Addend += Loc->second.second;
+        Relocations[Loc->second.first].push_back(RECopy);
+      }
+      ExternalSymbolRelocations.erase(Cur);
     }
   }
 }
@@ -219,7 +219,7 @@ void RuntimeDyldELF::resolveX86_64Relocation(uint8_t *LocalAddress,
   }
   case ELF::R_X86_64_PC32: {
     uint32_t *Placeholder = reinterpret_cast<uint32_t*>(LocalAddress);
-    int64_t RealOffset = *Placeholder + Value + Addend - FinalAddress;
+    int64_t RealOffset = Value + Addend - FinalAddress;
     assert(RealOffset <= 214783647 && RealOffset >= -214783648);
     int32_t TruncOffset = (RealOffset & 0xFFFFFFFF);
     *Placeholder = TruncOffset;
@@ -236,13 +236,12 @@ void RuntimeDyldELF::resolveX86Relocation(uint8_t *LocalAddress,
   switch (Type) {
   case ELF::R_386_32: {
     uint32_t *Target = (uint32_t*)(LocalAddress);
-    uint32_t Placeholder = *Target;
-    *Target = Placeholder + Value + Addend;
+    *Target = Value + Addend;
     break;
   }
   case ELF::R_386_PC32: {
     uint32_t *Placeholder = reinterpret_cast<uint32_t*>(LocalAddress);
-    uint32_t RealOffset = *Placeholder + Value + Addend - FinalAddress;
+    uint32_t RealOffset = Value + Addend - FinalAddress;
     *Placeholder = RealOffset;
     break;
     }
@@ -283,6 +282,7 @@ void RuntimeDyldELF::resolveARMRelocation(uint8_t *LocalAddress,
   // Last 4 bit should be shifted.
   case ELF::R_ARM_MOVW_ABS_NC :
     Value = Value & 0xFFFF;
+    *TargetPtr &= ~0x000F0FFFU;
     *TargetPtr |= Value & 0xFFF;
     *TargetPtr |= ((Value >> 12) & 0xF) << 16;
     break;
@@ -291,6 +291,7 @@ void RuntimeDyldELF::resolveARMRelocation(uint8_t *LocalAddress,
   // Last 4 bit should be shifted.
   case ELF::R_ARM_MOVT_ABS :
     Value = (Value >> 16) & 0xFFFF;
+    *TargetPtr &= ~0x000F0FFFU;
     *TargetPtr |= Value & 0xFFF;
     *TargetPtr |= ((Value >> 12) & 0xF) << 16;
     break;
@@ -426,6 +427,15 @@ void RuntimeDyldELF::processRelocationRef(const ObjRelocationInfo &Rel,
     }
   } else {
     RelocationEntry RE(Rel.SectionID, Rel.Offset, RelType, Value.Addend);
+    // These relocations add to the value already in place.  Move that value
+    // into the addend, so that resolving the relocation again, after a
+    // section has been remapped, gives the same result as the first time.
+    uint8_t *SectionAddress = Sections[Rel.SectionID].Address;
+    if (SectionAddress &&
+        ((Arch == Triple::x86_64 && RelType == ELF::R_X86_64_PC32) ||
+         (Arch == Triple::x86 &&
+          (RelType == ELF::R_386_32 || RelType == ELF::R_386_PC32))))
+      RE.Addend += *reinterpret_cast<int32_t*>(SectionAddress + Rel.Offset);
     if (Value.SymbolName)
       addRelocationForSymbol(RE, Value.SymbolName);
     else
@@ -138,9 +138,9 @@ protected:
   // Keep a map of common symbols to their sizes
   typedef std::map<SymbolRef, unsigned> CommonSymbolMap;
 
-  // For each symbol, keep a list of relocations based on it. Anytime
-  // its address is reassigned (the JIT re-compiled the function, e.g.),
-  // the relocations get re-resolved.
+  // For each symbol, keep a list of the relocations based on it that have
+  // not been resolved yet.  resolveRelocations() applies them and moves them
+  // to the resolved lists below.
   // The symbol (or section) the relocation is sourced from is the Key
   // in the relocation list where it's stored.
   typedef SmallVector<RelocationEntry, 64> RelocationList;
@@ -154,6 +154,15 @@ protected:
   // modules.  This map is indexed by symbol name.
   StringMap<RelocationList> ExternalSymbolRelocations;
 
+  // Relocations that have been applied, indexed like Relocations.  They are
+  // kept so that they can be applied again when a section is remapped.
+  DenseMap<unsigned, RelocationList> ResolvedRelocations;
+
+  // Applied relocations to external symbols, with the address each symbol
+  // resolved to.
+  typedef std::pair<uint64_t, RelocationList> ResolvedSymbol;
+  StringMap<ResolvedSymbol> ResolvedExternalSymbols;
+
   typedef std::map<RelocationValueRef, uintptr_t> StubMap;
 
   Triple::ArchType Arch;
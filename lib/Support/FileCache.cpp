@@ -0,0 +1,211 @@
+//===-- FileCache.cpp - On-disk cache of files ----------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements FileCache, a directory of generated files that can be
+// shared by several processes.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/FileCache.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+#include <algorithm>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+#include <fcntl.h>
+using namespace llvm;
+
+std::string FileCache::getKey(StringRef Inputs) {
+  MD5 Hash;
+  Hash.update(Inputs);
+  MD5::MD5Result Digest;
+  Hash.final(Digest);
+  SmallString<32> Key;
+  MD5::stringifyResult(Digest, Key);
+  return Key.str();
+}
+
+std::string FileCache::getEntryPath(StringRef Key) const {
+  SmallString<128> Path(Dir);
+  sys::path::append(Path, Key + ".cache");
+  return Path.str();
+}
+
+/// readEntry - Read the data of the entry open as FD if its header matches
+/// Prefix.  The data is mapped rather than read when it is large enough.
+static MemoryBuffer *readEntry(int FD, StringRef Path, StringRef Prefix) {
+  struct stat FileInfo;
+  if (fstat(FD, &FileInfo) == -1)
+    return 0;
+  uint64_t FileSize = FileInfo.st_size;
+
+  // The header is Prefix, the size of the data in decimal and a newline.
+  uint64_t HeaderMapSize = std::min(FileSize, uint64_t(Prefix.size() + 21));
+  OwningPtr<MemoryBuffer> Header;
+  if (MemoryBuffer::getOpenFile(FD, Path.str().c_str(), Header, FileSize,
+                                HeaderMapSize, 0, false))
+    return 0;
+  StringRef HeaderStr = Header->getBuffer();
+  if (!HeaderStr.startswith(Prefix))
+    return 0;
+  size_t Newline = HeaderStr.find('\n', Prefix.size());
+  uint64_t Size;
+  if (Newline == StringRef::npos ||
+      HeaderStr.slice(Prefix.size(), Newline).getAsInteger(10, Size) ||
+      FileSize - Newline - 1 != Size)
+    return 0;
+
+  OwningPtr<MemoryBuffer> Data;
+  if (MemoryBuffer::getOpenFile(FD, Path.str().c_str(), Data, FileSize, Size,
+                                Newline + 1, false))
+    return 0;
+  return Data.take();
+}
+
+MemoryBuffer *FileCache::lookup(StringRef Key) const {
+  std::string Path = getEntryPath(Key);
+  int OpenFlags = O_RDONLY;
+#ifdef O_BINARY
+  OpenFlags |= O_BINARY;  // Open input file in binary mode on win32.
+#endif
+  int FD = ::open(Path.c_str(), OpenFlags);
+  if (FD == -1)
+    return 0;
+  std::string Prefix = (Twine(Magic) + " " + Key + " ").str();
+  OwningPtr<MemoryBuffer> Data(readEntry(FD, Path, Prefix));
+  ::close(FD);
+  if (!Data)
+    return 0;
+
+  // Refresh the timestamp so that prune() evicts the least recently used
+  // entries first.
+  sys::PathWithStatus EntryPath(Path);
+  if (const sys::FileStatus *Status = EntryPath.getFileStatus()) {
+    sys::FileStatus NewStatus = *Status;
+    NewStatus.modTime = sys::TimeValue::now();
+    EntryPath.setStatusInfoOnDisk(NewStatus);
+  }
+
+  return Data.take();
+}
+
+/// writeAtomically - Write Data to a temporary file next to Path and rename it
+/// into place, so that readers either see the whole file or nothing.
+static bool writeAtomically(StringRef Path, StringRef Data,
+                            std::string &ErrMsg) {
+  int FD;
+  SmallString<128> TempPath;
+  if (error_code EC = sys::fs::unique_file(Path + "-%%%%%%.tmp", FD, TempPath,
+                                           /*makeAbsolute=*/false)) {
+    ErrMsg = "could not create cache file: " + EC.message();
+    return true;
+  }
+
+  bool WriteFailed;
+  {
+    raw_fd_ostream Out(FD, /*shouldClose=*/true);
+    Out << Data;
+    Out.close();
+    WriteFailed = Out.has_error();
+    Out.clear_error();
+  }
+
+  bool Existed;
+  if (WriteFailed) {
+    sys::fs::remove(TempPath.str(), Existed);
+    ErrMsg = "could not write cache file: " + TempPath.str().str();
+    return true;
+  }
+
+  if (error_code EC = sys::fs::rename(TempPath.str(), Path)) {
+    sys::fs::remove(TempPath.str(), Existed);
+    ErrMsg = "could not rename cache file: " + EC.message();
+    return true;
+  }
+  return false;
+}
+
+bool FileCache::store(StringRef Key, StringRef Data, std::string &ErrMsg) {
+  bool Existed;
+  if (error_code EC = sys::fs::create_directories(Dir, Existed)) {
+    ErrMsg = "could not create cache directory: " + EC.message();
+    return true;
+  }
+
+  std::string Entry;
+  raw_string_ostream OS(Entry);
+  OS << Magic << ' ' << Key << ' ' << Data.size() << '\n' << Data;
+  OS.flush();
+  return writeAtomically(getEntryPath(Key), Entry, ErrMsg);
+}
+
+namespace {
+  struct CacheEntry {
+    sys::TimeValue Time;
+    uint64_t Size;
+    std::string Path;
+
+    CacheEntry() : Time(0, 0), Size(0) {}
+  };
+}
+
+static bool isOlder(const CacheEntry &LHS, const CacheEntry &RHS) {
+  return LHS.Time < RHS.Time;
+}
+
+void FileCache::prune(uint64_t MaxSize) {
+  // Collect the complete entries.  Temporary and lock files belong to
+  // processes that are still running and are left alone.
+  std::vector<CacheEntry> Entries;
+  uint64_t TotalSize = 0;
+  error_code EC;
+  for (sys::fs::directory_iterator I(Dir, EC), E; I != E && !EC;
+       I.increment(EC)) {
+    StringRef Path = I->path();
+    if (sys::path::extension(Path) != ".cache")
+      continue;
+
+    sys::PathWithStatus EntryPath(Path);
+    const sys::FileStatus *Status = EntryPath.getFileStatus();
+    if (!Status)
+      continue;
+
+    CacheEntry Entry;
+    Entry.Time = Status->getTimestamp();
+    Entry.Path = Path;
+    Entry.Size = Status->getSize();
+    TotalSize += Entry.Size;
+    Entries.push_back(Entry);
+  }
+
+  if (TotalSize <= MaxSize)
+    return;
+
+  std::sort(Entries.begin(), Entries.end(), isOlder);
+  for (std::vector<CacheEntry>::iterator I = Entries.begin(),
+         E = Entries.end(); I != E && TotalSize > MaxSize; ++I) {
+    bool Existed;
+    sys::fs::remove(I->Path, Existed);
+    TotalSize -= I->Size;
+  }
+}
@@ -165,6 +165,12 @@ void Timer::stopTimer() {
   }
 }
 
+void Timer::addWallTime(double Seconds) {
+  assert(TG && "Timer not initialized");
+  Started = true;
+  Time.WallTime += Seconds;
+}
+
 static void printVal(double Val, double Total, raw_ostream &OS) {
   if (Total < 1e-7)   // Avoid dividing by zero.
     OS << "        -----     ";
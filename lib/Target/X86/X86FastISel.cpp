@@ -103,6 +103,8 @@ private:
 
   bool X86SelectShift(const Instruction *I);
 
+  bool X86SelectDivRem(const Instruction *I);
+
   bool X86SelectSelect(const Instruction *I);
 
   bool X86SelectTrunc(const Instruction *I);
@@ -1211,6 +1213,123 @@ bool X86FastISel::X86SelectShift(const Instruction *I) {
   return true;
 }
 
+bool X86FastISel::X86SelectDivRem(const Instruction *I) {
+  // DIV and IDIV divide the register pair HighReg:LowReg by their operand,
+  // leaving the quotient in LowReg and the remainder in HighReg.  The i8
+  // forms are the exception: they divide AX, so the dividend is extended
+  // straight into AX, and leave the results in AL and AH.
+  bool IsSigned = I->getOpcode() == Instruction::SDiv ||
+                  I->getOpcode() == Instruction::SRem;
+  bool IsRem = I->getOpcode() == Instruction::SRem ||
+               I->getOpcode() == Instruction::URem;
+
+  MVT VT;
+  if (!isTypeLegal(I->getType(), VT))
+    return false;
+
+  const TargetRegisterClass *RC;
+  unsigned LowReg, HighReg, DivOpc, SignExtOpc;
+  switch (VT.SimpleTy) {
+  default: return false;
+  case MVT::i8:
+    RC = &X86::GR8RegClass;
+    LowReg = X86::AX;
+    HighReg = 0;
+    DivOpc = IsSigned ? X86::IDIV8r : X86::DIV8r;
+    SignExtOpc = 0;
+    break;
+  case MVT::i16:
+    RC = &X86::GR16RegClass;
+    LowReg = X86::AX;
+    HighReg = X86::DX;
+    DivOpc = IsSigned ? X86::IDIV16r : X86::DIV16r;
+    SignExtOpc = X86::CWD;
+    break;
+  case MVT::i32:
+    RC = &X86::GR32RegClass;
+    LowReg = X86::EAX;
+    HighReg = X86::EDX;
+    DivOpc = IsSigned ? X86::IDIV32r : X86::DIV32r;
+    SignExtOpc = X86::CDQ;
+    break;
+  case MVT::i64:
+    RC = &X86::GR64RegClass;
+    LowReg = X86::RAX;
+    HighReg = X86::RDX;
+    DivOpc = IsSigned ? X86::IDIV64r : X86::DIV64r;
+    SignExtOpc = X86::CQO;
+    break;
+  }
+
+  unsigned Op0Reg = getRegForValue(I->getOperand(0));
+  if (Op0Reg == 0) return false;
+  unsigned Op1Reg = getRegForValue(I->getOperand(1));
+  if (Op1Reg == 0) return false;
+
+  if (VT == MVT::i8) {
+    // Extend the dividend into AX.
+    unsigned ExtOpc = IsSigned ? X86::MOVSX16rr8 : X86::MOVZX16rr8;
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(ExtOpc), LowReg)
+      .addReg(Op0Reg);
+  } else {
+    // Copy the dividend into LowReg, then sign-extend it into HighReg or
+    // clear HighReg.
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(TargetOpcode::COPY),
+            LowReg).addReg(Op0Reg);
+    if (IsSigned) {
+      BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(SignExtOpc));
+    } else {
+      unsigned Zero32 = createResultReg(&X86::GR32RegClass);
+      BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(X86::MOV32r0),
+              Zero32);
+      if (VT == MVT::i16)
+        BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+                TII.get(TargetOpcode::COPY), HighReg)
+          .addReg(Zero32, RegState::Kill, X86::sub_16bit);
+      else if (VT == MVT::i32)
+        BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+                TII.get(TargetOpcode::COPY), HighReg)
+          .addReg(Zero32, RegState::Kill);
+      else
+        BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL,
+                TII.get(TargetOpcode::SUBREG_TO_REG), HighReg)
+          .addImm(0).addReg(Zero32, RegState::Kill).addImm(X86::sub_32bit);
+    }
+  }
+
+  BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(DivOpc))
+    .addReg(Op1Reg);
+
+  unsigned ResultReg = 0;
+  if (VT == MVT::i8 && IsRem && Subtarget->is64Bit()) {
+    // Don't copy out of AH in 64-bit mode: the copy could end up in an
+    // instruction that needs a REX prefix, which cannot encode AH.  Shift
+    // the remainder down from AX instead.
+    unsigned SourceReg = createResultReg(&X86::GR16RegClass);
+    unsigned ShiftedReg = createResultReg(&X86::GR16RegClass);
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(TargetOpcode::COPY),
+            SourceReg).addReg(X86::AX);
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(X86::SHR16ri),
+            ShiftedReg).addReg(SourceReg, RegState::Kill).addImm(8);
+    ResultReg = FastEmitInst_extractsubreg(MVT::i8, ShiftedReg, /*Kill=*/true,
+                                           X86::sub_8bit);
+  } else {
+    unsigned ResultPhysReg;
+    if (VT == MVT::i8)
+      ResultPhysReg = IsRem ? X86::AH : X86::AL;
+    else
+      ResultPhysReg = IsRem ? HighReg : LowReg;
+    ResultReg = createResultReg(RC);
+    BuildMI(*FuncInfo.MBB, FuncInfo.InsertPt, DL, TII.get(TargetOpcode::COPY),
+            ResultReg).addReg(ResultPhysReg);
+  }
+  if (ResultReg == 0)
+    return false;
+
+  UpdateValueMap(I, ResultReg);
+  return true;
+}
+
 bool X86FastISel::X86SelectSelect(const Instruction *I) {
   MVT VT;
   if (!isTypeLegal(I->getType(), VT))
@@ -1965,6 +2084,11 @@ X86FastISel::TargetSelectInstruction(const Instruction *I)  {
   case Instruction::AShr:
   case Instruction::Shl:
     return X86SelectShift(I);
+  case Instruction::SDiv:
+  case Instruction::UDiv:
+  case Instruction::SRem:
+  case Instruction::URem:
+    return X86SelectDivRem(I);
   case Instruction::Select:
     return X86SelectSelect(I);
   case Instruction::Trunc:
@@ -0,0 +1,135 @@
+//===- ProfileMetadataPass.cpp - Attach profile info as branch weights ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that copies the edge weights of the current
+// ProfileInfo implementation onto branches as !prof branch_weights metadata.
+// BranchProbabilityInfo, and through it MachineBranchProbabilityInfo and block
+// placement, only understand the metadata, so this is what lets an edge
+// profile loaded with -profile-loader steer code generation.
+//
+//===----------------------------------------------------------------------===//
+#define DEBUG_TYPE "profile-metadata"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Pass.h"
+#include "llvm/Transforms/Instrumentation.h"
+#include "llvm/Analysis/ProfileInfo.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MDBuilder.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumBranchesAnnotated, "Number of branches given profile weights");
+STATISTIC(NumBranchesSkipped,   "Number of branches without usable profile");
+
+namespace {
+  class ProfileMetadataPass : public FunctionPass {
+    bool annotateTerminator(TerminatorInst *TI, ProfileInfo &PI);
+  public:
+    static char ID; // Class identification, replacement for typeinfo
+    ProfileMetadataPass() : FunctionPass(ID) {
+      initializeProfileMetadataPassPass(*PassRegistry::getPassRegistry());
+    }
+
+    virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+      AU.setPreservesCFG();
+      AU.addRequired<ProfileInfo>();
+    }
+
+    virtual const char *getPassName() const {
+      return "Profile information to branch weight metadata";
+    }
+
+    virtual bool runOnFunction(Function &F);
+  };
+}  // End of anonymous namespace
+
+char ProfileMetadataPass::ID = 0;
+INITIALIZE_PASS_BEGIN(ProfileMetadataPass, "profile-metadata",
+                "Attach profile information as branch weights", false, false)
+INITIALIZE_AG_DEPENDENCY(ProfileInfo)
+INITIALIZE_PASS_END(ProfileMetadataPass, "profile-metadata",
+                "Attach profile information as branch weights", false, false)
+
+FunctionPass *llvm::createProfileMetadataPass() {
+  return new ProfileMetadataPass();
+}
+
+/// annotateTerminator - Replace the branch weights of TI with the edge weights
+/// recorded in PI.  Returns true if the metadata was set.
+bool ProfileMetadataPass::annotateTerminator(TerminatorInst *TI,
+                                             ProfileInfo &PI) {
+  BasicBlock *BB = TI->getParent();
+  unsigned NumSuccs = TI->getNumSuccessors();
+
+  // ProfileInfo records one weight per CFG edge, while the metadata has one
+  // weight per successor operand.  Split the weight of an edge evenly among
+  // the operands that name the same destination.
+  SmallVector<double, 4> Weights(NumSuccs);
+  double MaxWeight = 0;
+  for (unsigned i = 0; i != NumSuccs; ++i) {
+    BasicBlock *Succ = TI->getSuccessor(i);
+    double W = PI.getEdgeWeight(ProfileInfo::getEdge(BB, Succ));
+    if (W == ProfileInfo::MissingValue)
+      return false;
+
+    unsigned Duplicates = 0;
+    for (unsigned j = 0; j != NumSuccs; ++j)
+      if (TI->getSuccessor(j) == Succ)
+        ++Duplicates;
+    Weights[i] = W / Duplicates;
+    MaxWeight = std::max(MaxWeight, Weights[i]);
+  }
+
+  // A block that never ran says nothing about its branches.
+  if (MaxWeight == 0)
+    return false;
+
+  // BranchProbabilityInfo clamps each weight so that their sum fits in 32
+  // bits.  Scale large counts down to that limit up front so that the ratios
+  // between the successors survive.
+  double Limit = UINT32_MAX / NumSuccs;
+  double Scale = 1.0;
+  if (MaxWeight > Limit)
+    Scale = Limit / MaxWeight;
+
+  SmallVector<uint32_t, 4> Scaled(NumSuccs);
+  for (unsigned i = 0; i != NumSuccs; ++i)
+    Scaled[i] = static_cast<uint32_t>(Weights[i] * Scale + 0.5);
+
+  MDBuilder MDB(TI->getContext());
+  TI->setMetadata(LLVMContext::MD_prof, MDB.createBranchWeights(Scaled));
+  return true;
+}
+
+bool ProfileMetadataPass::runOnFunction(Function &F) {
+  ProfileInfo &PI = getAnalysis<ProfileInfo>();
+  bool Changed = false;
+
+  for (Function::iterator BB = F.begin(), E = F.end(); BB != E; ++BB) {
+    TerminatorInst *TI = BB->getTerminator();
+    // These are the only terminators BranchProbabilityInfo reads weights from.
+    if (TI->getNumSuccessors() < 2 ||
+        (!isa<BranchInst>(TI) && !isa<SwitchInst>(TI)))
+      continue;
+
+    if (annotateTerminator(TI, PI)) {
+      DEBUG(dbgs() << "Annotated " << F.getName() << ":" << BB->getName()
+                   << " " << *TI->getMetadata(LLVMContext::MD_prof) << "\n");
+      ++NumBranchesAnnotated;
+      Changed = true;
+    } else {
+      ++NumBranchesSkipped;
+    }
+  }
+  return Changed;
+}
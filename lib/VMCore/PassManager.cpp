@@ -16,6 +16,7 @@
 #include "llvm/PassManager.h"
 #include "llvm/Assembly/PrintModulePass.h"
 #include "llvm/Assembly/Writer.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Timer.h"
@@ -23,6 +24,8 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/PassNameParser.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/TimeValue.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Mutex.h"
 #include <algorithm>
@@ -466,6 +469,76 @@ public:
 
 static TimingInfo *TheTimeInfo;
 
+static ManagedStatic<sys::SmartMutex<true> > PassProfilerMutex;
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+/// PassProfiler Class - This class records one trace event for every pass
+/// execution on a module, function, basic block, loop or call graph SCC: its
+/// wall time, the change in the unit's instruction count and the change in
+/// malloc'd bytes.  Events are streamed to the file given by -pass-profile in
+/// the Chrome trace-event JSON format, so the result loads into
+/// chrome://tracing or any JSON tool.  When -pass-profile is not given, the
+/// only cost is a null pointer test per pass execution.
+///
+class PassProfiler {
+  raw_fd_ostream *OS;
+  uint64_t StartTime;
+  bool NeedsComma;
+public:
+  // Use 'createThePassProfiler' to get this.
+  PassProfiler();
+  ~PassProfiler();
+
+  // createThePassProfiler - Like TimingInfo::createTheTimeInfo, but for
+  // -pass-profile.  It may be called multiple times.
+  static void createThePassProfiler();
+
+  /// recordExecution - Emit the trace event for one execution of P on the IR
+  /// unit named UnitName.
+  void recordExecution(Pass *P, const char *Category, StringRef UnitName,
+                       uint64_t Begin, uint64_t End,
+                       unsigned InstrsBefore, unsigned InstrsAfter,
+                       size_t MallocBefore, size_t MallocAfter);
+};
+
+} // End of anon namespace
+
+static PassProfiler *ThePassProfiler;
+
+namespace llvm {
+
+template<> struct PassProfileTraits<BasicBlock> {
+  static const char *getCategory() { return "basicblock"; }
+  static std::string getName(BasicBlock &BB) { return BB.getName(); }
+  static unsigned countInstructions(BasicBlock &BB) { return BB.size(); }
+};
+
+template<> struct PassProfileTraits<Function> {
+  static const char *getCategory() { return "function"; }
+  static std::string getName(Function &F) { return F.getName(); }
+  static unsigned countInstructions(Function &F) {
+    unsigned Count = 0;
+    for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
+      Count += I->size();
+    return Count;
+  }
+};
+
+template<> struct PassProfileTraits<Module> {
+  static const char *getCategory() { return "module"; }
+  static std::string getName(Module &M) { return M.getModuleIdentifier(); }
+  static unsigned countInstructions(Module &M) {
+    unsigned Count = 0;
+    for (Module::iterator I = M.begin(), E = M.end(); I != E; ++I)
+      Count += PassProfileTraits<Function>::countInstructions(*I);
+    return Count;
+  }
+};
+
+} // End llvm namespace
+
 //===----------------------------------------------------------------------===//
 // PMTopLevelManager implementation
 
@@ -1259,6 +1332,7 @@ bool BBPassManager::runOnFunction(Function &F) {
         // If the pass crashes, remember this.
         PassManagerPrettyStackEntry X(BP, *I);
         TimeRegion PassTimer(getPassTimer(BP));
+        PassProfileRegion<BasicBlock> PassProfile(BP, *I);
 
         LocalChanged |= BP->runOnBasicBlock(*I);
       }
@@ -1423,6 +1497,7 @@ void FunctionPassManagerImpl::releaseMemoryOnTheFly() {
 bool FunctionPassManagerImpl::run(Function &F) {
   bool Changed = false;
   TimingInfo::createTheTimeInfo();
+  PassProfiler::createThePassProfiler();
 
   initializeAllAnalysisInfo();
   for (unsigned Index = 0; Index < getNumContainedManagers(); ++Index)
@@ -1474,6 +1549,7 @@ bool FPPassManager::runOnFunction(Function &F) {
     {
       PassManagerPrettyStackEntry X(FP, F);
       TimeRegion PassTimer(getPassTimer(FP));
+      PassProfileRegion<Function> PassProfile(FP, F);
 
       LocalChanged |= FP->runOnFunction(F);
     }
@@ -1548,6 +1624,7 @@ MPPassManager::runOnModule(Module &M) {
     {
       PassManagerPrettyStackEntry X(MP, M);
       TimeRegion PassTimer(getPassTimer(MP));
+      PassProfileRegion<Module> PassProfile(MP, M);
 
       LocalChanged |= MP->runOnModule(M);
     }
@@ -1626,6 +1703,7 @@ Pass* MPPassManager::getOnTheFlyPass(Pass *MP, AnalysisID PI, Function &F){
 bool PassManagerImpl::run(Module &M) {
   bool Changed = false;
   TimingInfo::createTheTimeInfo();
+  PassProfiler::createThePassProfiler();
 
   dumpArguments();
   dumpPasses();
@@ -1694,6 +1772,104 @@ Timer *llvm::getPassTimer(Pass *P) {
   return 0;
 }
 
+//===----------------------------------------------------------------------===//
+// PassProfiler implementation
+//
+static cl::opt<std::string>
+PassProfileFile("pass-profile", cl::value_desc("filename"),
+                cl::desc("Write a per-pass, per-function execution profile "
+                         "in Chrome trace-event format to the given file"));
+
+PassProfileEvent::PassProfileEvent(Pass *P)
+  : P(ThePassProfiler ? P : 0), Begin(0), End(0), InstrsBefore(0),
+    MallocBefore(0), MallocAfter(0) {}
+
+void PassProfileEvent::start(const std::string &Name, unsigned Instrs) {
+  UnitName = Name;
+  InstrsBefore = Instrs;
+  MallocBefore = sys::Process::GetMallocUsage();
+  Begin = sys::TimeValue::now().usec();
+}
+
+void PassProfileEvent::stop() {
+  End = sys::TimeValue::now().usec();
+  MallocAfter = sys::Process::GetMallocUsage();
+}
+
+void PassProfileEvent::record(const char *Category, unsigned InstrsAfter) {
+  ThePassProfiler->recordExecution(P, Category, UnitName, Begin, End,
+                                   InstrsBefore, InstrsAfter,
+                                   MallocBefore, MallocAfter);
+}
+
+void PassProfiler::createThePassProfiler() {
+  if (PassProfileFile.empty() || ThePassProfiler) return;
+
+  // As with TimingInfo, the ManagedStatic makes sure the trace is finished
+  // when llvm_shutdown runs.
+  static ManagedStatic<PassProfiler> TPP;
+  ThePassProfiler = &*TPP;
+}
+
+PassProfiler::PassProfiler()
+  : OS(0), StartTime(sys::TimeValue::now().usec()), NeedsComma(false) {
+  std::string ErrorInfo;
+  OS = new raw_fd_ostream(PassProfileFile.c_str(), ErrorInfo);
+  if (!ErrorInfo.empty()) {
+    errs() << "Error opening pass profile file '" << PassProfileFile
+           << "': " << ErrorInfo << '\n';
+    delete OS;
+    OS = 0;
+    return;
+  }
+  *OS << "{\"traceEvents\":[";
+}
+
+PassProfiler::~PassProfiler() {
+  if (!OS) return;
+  *OS << "\n]}\n";
+  delete OS;
+}
+
+/// writeJSONString - Print S as a quoted JSON string.
+static void writeJSONString(raw_ostream &OS, StringRef S) {
+  OS << '"';
+  for (StringRef::iterator I = S.begin(), E = S.end(); I != E; ++I) {
+    unsigned char C = *I;
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if (C < 0x20)
+      OS << "\\u00" << hexdigit(C >> 4) << hexdigit(C & 15);
+    else
+      OS << C;
+  }
+  OS << '"';
+}
+
+void PassProfiler::recordExecution(Pass *P, const char *Category,
+                                   StringRef UnitName,
+                                   uint64_t Begin, uint64_t End,
+                                   unsigned InstrsBefore, unsigned InstrsAfter,
+                                   size_t MallocBefore, size_t MallocAfter) {
+  sys::SmartScopedLock<true> Lock(*PassProfilerMutex);
+  if (!OS) return;
+
+  // Durations are in microseconds, relative to when profiling started.
+  if (NeedsComma)
+    *OS << ',';
+  NeedsComma = true;
+  *OS << "\n{\"name\":";
+  writeJSONString(*OS, P->getPassName());
+  *OS << ",\"cat\":\"" << Category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+      << ",\"ts\":" << (Begin - StartTime) << ",\"dur\":" << (End - Begin)
+      << ",\"args\":{\"unit\":";
+  writeJSONString(*OS, UnitName);
+  *OS << ",\"instrs_before\":" << InstrsBefore
+      << ",\"instrs_after\":" << InstrsAfter
+      << ",\"malloc_delta\":"
+      << (int64_t(MallocAfter) - int64_t(MallocBefore)) << "}}";
+}
+
 //===----------------------------------------------------------------------===//
 // PMStack implementation
 //
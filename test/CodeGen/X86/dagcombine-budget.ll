@@ -0,0 +1,27 @@
+; RUN: llc < %s -march=x86 -combiner-max-visits=4 | FileCheck %s
+; RUN: llc < %s -march=x86 -combiner-max-visits=4 -o /dev/null -stats \
+; RUN:   -info-output-file - | FileCheck %s -check-prefix=STATS
+; RUN: llc < %s -march=x86 -o /dev/null -stats -info-output-file - \
+; RUN:   | FileCheck %s -check-prefix=OPCODES
+; REQUIRES: asserts
+
+; The DAG below has more than four nodes, so every combiner run stops early.
+; Code generation must still succeed.
+
+; CHECK: test:
+; CHECK: ret
+; STATS: {{[1-9]}} dagcombine{{ *}} - Number of combiner runs that hit the budget
+
+; Without a budget, the xor of an xor with -1 folds away.
+; OPCODES: {{[1-9]}} dagcombine{{ *}} - Number of xor nodes combined
+
+define i32 @test(i32 %x, i32 %y) nounwind {
+  %a = shl i32 %x, 2
+  %b = shl i32 %a, 3
+  %c = and i32 %b, 255
+  %d = and i32 %c, 15
+  %e = or i32 %d, %y
+  %f = xor i32 %e, -1
+  %g = xor i32 %f, -1
+  ret i32 %g
+}
@@ -0,0 +1,61 @@
+; RUN: llc < %s -fast-isel -O0 -asm-verbose=0 -fast-isel-abort -mtriple=x86_64-unknown-unknown | FileCheck %s
+
+; Integer division and remainder are selected by fast-isel rather than
+; falling back to SelectionDAG.
+
+define i8 @test_sdiv8(i8 %dividend, i8 %divisor) nounwind {
+  %result = sdiv i8 %dividend, %divisor
+  ret i8 %result
+}
+; CHECK: test_sdiv8:
+; CHECK: movsbw
+; CHECK: idivb
+
+define i8 @test_urem8(i8 %dividend, i8 %divisor) nounwind {
+  %result = urem i8 %dividend, %divisor
+  ret i8 %result
+}
+; CHECK: test_urem8:
+; CHECK: movzbw
+; CHECK: divb
+; CHECK: shrw $8
+
+define i16 @test_srem16(i16 %dividend, i16 %divisor) nounwind {
+  %result = srem i16 %dividend, %divisor
+  ret i16 %result
+}
+; CHECK: test_srem16:
+; CHECK: cwtd
+; CHECK: idivw
+
+define i32 @test_udiv32(i32 %dividend, i32 %divisor) nounwind {
+  %result = udiv i32 %dividend, %divisor
+  ret i32 %result
+}
+; CHECK: test_udiv32:
+; CHECK: xorl
+; CHECK: divl
+
+define i32 @test_srem32(i32 %dividend, i32 %divisor) nounwind {
+  %result = srem i32 %dividend, %divisor
+  ret i32 %result
+}
+; CHECK: test_srem32:
+; CHECK: cltd
+; CHECK: idivl
+
+define i64 @test_sdiv64(i64 %dividend, i64 %divisor) nounwind {
+  %result = sdiv i64 %dividend, %divisor
+  ret i64 %result
+}
+; CHECK: test_sdiv64:
+; CHECK: cqto
+; CHECK: idivq
+
+define i64 @test_urem64(i64 %dividend, i64 %divisor) nounwind {
+  %result = urem i64 %dividend, %divisor
+  ret i64 %result
+}
+; CHECK: test_urem64:
+; CHECK: xorl
+; CHECK: divq
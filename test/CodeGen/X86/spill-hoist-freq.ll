@@ -0,0 +1,77 @@
+; RUN: llc < %s -mtriple=x86_64-linux -o /dev/null -stats -info-output-file - \
+; RUN:   | FileCheck %s
+; REQUIRES: asserts
+
+; Ten values loaded in the entry block are live around the loop, but only the
+; rarely taken %cold block needs them across a call.  Their spills belong in
+; %cold.  Hoisting them to the entry block, as a loop depth comparison would,
+; executes them on every call of @f instead of on one in a thousand
+; iterations.
+
+; CHECK-NOT: Number of hoisted spills
+; CHECK: 1 regalloc - Spill slot stores per function entry
+
+declare void @g()
+
+define i64 @f(i64* %p, i64 %n) nounwind {
+entry:
+  %a0p = getelementptr i64* %p, i64 0
+  %a0 = load volatile i64* %a0p
+  %a1p = getelementptr i64* %p, i64 1
+  %a1 = load volatile i64* %a1p
+  %a2p = getelementptr i64* %p, i64 2
+  %a2 = load volatile i64* %a2p
+  %a3p = getelementptr i64* %p, i64 3
+  %a3 = load volatile i64* %a3p
+  %a4p = getelementptr i64* %p, i64 4
+  %a4 = load volatile i64* %a4p
+  %a5p = getelementptr i64* %p, i64 5
+  %a5 = load volatile i64* %a5p
+  %a6p = getelementptr i64* %p, i64 6
+  %a6 = load volatile i64* %a6p
+  %a7p = getelementptr i64* %p, i64 7
+  %a7 = load volatile i64* %a7p
+  %a8p = getelementptr i64* %p, i64 8
+  %a8 = load volatile i64* %a8p
+  %a9p = getelementptr i64* %p, i64 9
+  %a9 = load volatile i64* %a9p
+  br label %loop
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]
+  %s = phi i64 [ 0, %entry ], [ %s.next, %latch ]
+  %h = and i64 %i, 1023
+  %c = icmp eq i64 %h, 0
+  br i1 %c, label %cold, label %latch, !prof !0
+cold:
+  call void @g()
+  %c0 = add i64 %s, %a0
+  %c1 = add i64 %c0, %a1
+  %c2 = add i64 %c1, %a2
+  %c3 = add i64 %c2, %a3
+  %c4 = add i64 %c3, %a4
+  %c5 = add i64 %c4, %a5
+  %c6 = add i64 %c5, %a6
+  %c7 = add i64 %c6, %a7
+  %c8 = add i64 %c7, %a8
+  %c9 = add i64 %c8, %a9
+  br label %latch
+latch:
+  %t = phi i64 [ %s, %loop ], [ %c9, %cold ]
+  %h0 = xor i64 %t, %a0
+  %h1 = xor i64 %h0, %a1
+  %h2 = xor i64 %h1, %a2
+  %h3 = xor i64 %h2, %a3
+  %h4 = xor i64 %h3, %a4
+  %h5 = xor i64 %h4, %a5
+  %h6 = xor i64 %h5, %a6
+  %h7 = xor i64 %h6, %a7
+  %h8 = xor i64 %h7, %a8
+  %h9 = xor i64 %h8, %a9
+  %s.next = add i64 %h9, %i
+  %i.next = add i64 %i, 1
+  %e = icmp eq i64 %i.next, %n
+  br i1 %e, label %exit, label %loop
+exit:
+  ret i64 %s.next
+}
+!0 = metadata !{metadata !"branch_weights", i32 1, i32 1000}
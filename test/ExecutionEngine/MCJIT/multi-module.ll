@@ -0,0 +1,25 @@
+; RUN: echo {@counter = external global i32 \
+; RUN:   define i32 @bump(i32 %x) \{ \
+; RUN:     %c = load i32* @counter \
+; RUN:     %n = add i32 %c, %x \
+; RUN:     store i32 %n, i32* @counter \
+; RUN:     ret i32 %n \
+; RUN:   \} } | llvm-as > %t.bc
+; RUN: %lli -use-mcjit -extra-module=%t.bc %s
+
+; The extra module refers back to @counter, which is defined here, while main
+; calls @bump, which is defined there.  Both directions have to be linked.
+
+@counter = global i32 3
+
+declare i32 @bump(i32)
+
+define i32 @main() {
+  %a = call i32 @bump(i32 4)
+  %b = call i32 @bump(i32 -7)
+  %c = load i32* @counter
+  %r = or i32 %b, %c
+  %ok = icmp eq i32 %a, 7
+  %res = select i1 %ok, i32 %r, i32 1
+  ret i32 %res
+}
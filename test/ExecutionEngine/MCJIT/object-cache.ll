@@ -0,0 +1,29 @@
+; RUN: rm -rf %t.cache
+; RUN: %lli -use-mcjit -object-cache-dir=%t.cache \
+; RUN:   -stats -info-output-file - %s | FileCheck %s -check-prefix=MISS
+; RUN: %lli -use-mcjit -object-cache-dir=%t.cache \
+; RUN:   -stats -info-output-file - %s | FileCheck %s -check-prefix=HIT
+; REQUIRES: asserts
+
+; Running the same module twice reuses the object file from the cache, and
+; the reused code computes the same result.
+
+; MISS: 1 lli - Number of objects missing from the object cache
+; MISS-NOT: reused from the object cache
+; HIT: 1 lli - Number of objects reused from the object cache
+; HIT-NOT: missing from the object cache
+
+@g = global i32 40
+
+define i32 @add(i32 %x) {
+  %v = load i32* @g
+  %r = add i32 %v, %x
+  ret i32 %r
+}
+
+define i32 @main() {
+  %r = call i32 @add(i32 2)
+  %ok = icmp eq i32 %r, 42
+  %ret = select i1 %ok, i32 0, i32 1
+  ret i32 %ret
+}
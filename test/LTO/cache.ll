@@ -0,0 +1,21 @@
+; RUN: llvm-as < %s > %t.bc
+; RUN: rm -rf %t.cache
+; RUN: llvm-lto -exported-symbol=main -cache-dir=%t.cache -o %t1.o %t.bc \
+; RUN:   -stats -info-output-file - | FileCheck %s -check-prefix=MISS
+; RUN: llvm-lto -exported-symbol=main -cache-dir=%t.cache -o %t2.o %t.bc \
+; RUN:   -stats -info-output-file - | FileCheck %s -check-prefix=HIT
+; RUN: cmp %t1.o %t2.o
+; REQUIRES: asserts
+
+; Linking the same input twice reuses the object file from the cache.
+
+; MISS: 1 lto - Number of native objects missing from the LTO cache
+; MISS-NOT: reused from the LTO cache
+; HIT: 1 lto - Number of native objects reused from the LTO cache
+; HIT-NOT: missing from the LTO cache
+
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @main() {
+  ret i32 0
+}
@@ -0,0 +1,27 @@
+@data = global i32 1
+@internal_data = internal global i32 2
+@extern_data = external global i32
+
+@alias = alias i32 ()* @defined
+
+define i32 @defined() {
+  %x = load i32* @extern_data
+  %y = call i32 @internal_fn()
+  %z = add i32 %x, %y
+  ret i32 %z
+}
+
+define internal i32 @internal_fn() {
+  %x = load i32* @internal_data
+  ret i32 %x
+}
+
+define weak i32 @weak_fn() {
+  ret i32 0
+}
+
+define linkonce_odr i32 @linkonce_fn() {
+  ret i32 0
+}
+
+declare i32 @undefined()
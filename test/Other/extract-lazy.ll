@@ -0,0 +1,24 @@
+; RUN: llvm-as < %s > %t
+; RUN: llvm-extract -func foo -S %t | FileCheck %s
+; RUN: llvm-extract -func foo -stats -info-output-file - -o /dev/null %t | \
+; RUN:   FileCheck %s -check-prefix=STATS
+; REQUIRES: asserts
+
+; llvm-extract loads bitcode lazily, so only the body of the extracted function
+; should be read.
+
+; CHECK: define void @foo()
+; STATS: 3 bitcode-reader{{ *}} - Number of function bodies deferred
+; STATS: 1 bitcode-reader{{ *}} - Number of function bodies materialized
+
+define void @foo() {
+  ret void
+}
+define void @bar() {
+  call void @foo()
+  ret void
+}
+define void @baz() {
+  call void @bar()
+  ret void
+}
@@ -0,0 +1,24 @@
+; RUN: opt < %s -functionattrs -loop-deletion -pass-profile=%t -disable-output
+; RUN: FileCheck %s < %t
+
+; Loop and call graph SCC passes are profiled too.  Loop deletion removes the
+; loop it runs on; instructions are counted over the enclosing function.
+
+; CHECK: {"traceEvents":[
+; CHECK: {"name":"Deduce function attributes","cat":"scc",{{.*}}"args":{"unit":"count","instrs_before":6,"instrs_after":6,
+; CHECK: {"name":"Delete dead loops","cat":"loop",{{.*}}"args":{"unit":"count:loop","instrs_before":6,"instrs_after":2,
+; CHECK: ]}
+
+define void @count(i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %i.next = add i32 %i, 1
+  %c = icmp slt i32 %i.next, %n
+  br i1 %c, label %loop, label %exit
+
+exit:
+  ret void
+}
@@ -0,0 +1,17 @@
+; RUN: opt < %s -instcombine -globaldce -pass-profile=%t -disable-output
+; RUN: FileCheck %s < %t
+
+; CHECK: {"traceEvents":[
+; CHECK: {"name":"Combine redundant instructions","cat":"function","ph":"X","pid":0,"tid":0,"ts":{{[0-9]+}},"dur":{{[0-9]+}},"args":{"unit":"foo","instrs_before":2,"instrs_after":1,"malloc_delta":{{-?[0-9]+}}}}
+; CHECK: {"name":"Combine redundant instructions","cat":"function",{{.*}}"args":{"unit":"q\"uote","instrs_before":1,"instrs_after":1,
+; CHECK: {"name":"Dead Global Elimination","cat":"module",{{.*}}"args":{"unit":"<stdin>","instrs_before":2,"instrs_after":1,
+; CHECK: ]}
+
+define i32 @foo(i32 %x) {
+  %a = add i32 %x, 0
+  ret i32 %a
+}
+
+define internal void @"q\22uote"() {
+  ret void
+}
@@ -0,0 +1,49 @@
+; RUN: opt < %s -profile-estimator -profile-metadata -S | FileCheck %s
+; RUN: opt < %s -analyze -profile-estimator -branch-prob -profile-metadata \
+; RUN:   -branch-prob | FileCheck %s -check-prefix=BPI
+
+; The estimator takes the loop latch ten times for every exit.  Its counts do
+; not fit in 32 bits, so the weights are scaled down, keeping their ratios.
+; Branch probabilities computed before the weights were attached are not
+; reused afterwards.
+
+; BPI: edge loop -> exit probability is 4 / 128
+; BPI: edge loop -> exit probability is 214748365 / 2362232012
+
+define i32 @sum(i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %acc = phi i32 [ 0, %entry ], [ %acc.next, %loop ]
+  %acc.next = add i32 %acc, %i
+  %i.next = add i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %loop
+; CHECK: br i1 %done, label %exit, label %loop, !prof !0
+
+exit:
+  ret i32 %acc.next
+}
+
+define i32 @pick(i32 %x) {
+entry:
+  switch i32 %x, label %other [
+    i32 0, label %zero
+    i32 1, label %one
+  ]
+; CHECK: ], !prof !1
+
+zero:
+  ret i32 10
+
+one:
+  ret i32 11
+
+other:
+  ret i32 12
+}
+
+; CHECK: !0 = metadata !{metadata !"branch_weights", i32 214748365, i32 2147483647}
+; CHECK: !1 = metadata !{metadata !"branch_weights", i32 1431655764, i32 1431655764, i32 1431655765}
@@ -0,0 +1,81 @@
+//===- DiskObjectCache.cpp - On-disk cache of MCJIT object files ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements an ObjectCache that keeps MCJIT object files in a
+// directory, so that later runs of the same module skip code generation.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "lli"
+#include "DiskObjectCache.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+STATISTIC(NumCacheHits,   "Number of objects reused from the object cache");
+STATISTIC(NumCacheMisses, "Number of objects missing from the object cache");
+
+std::string DiskObjectCache::getKey(const Module *M) const {
+  std::string Inputs;
+  raw_string_ostream OS(Inputs);
+  OS << PACKAGE_VERSION << '\0' << TargetKey << '\0';
+  WriteBitcodeToFile(M, OS);
+  OS.flush();
+  return FileCache::getKey(Inputs);
+}
+
+MemoryBuffer *DiskObjectCache::getObject(const Module *M) {
+  std::string Key = getKey(M);
+  if (MemoryBuffer *Object = Cache.lookup(Key)) {
+    ++NumCacheHits;
+    return Object;
+  }
+
+  // Another process may be generating the same object; if so, wait for it
+  // rather than doing the same work twice.  LockFileManager needs the
+  // directory to exist already.
+  bool Existed;
+  std::string Path = Cache.getEntryPath(Key);
+  if (!sys::fs::create_directories(sys::path::parent_path(Path), Existed)) {
+    OwningPtr<LockFileManager> EntryLock(new LockFileManager(Path));
+    if (EntryLock->getState() == LockFileManager::LFS_Shared) {
+      EntryLock->waitForUnlock();
+      if (MemoryBuffer *Object = Cache.lookup(Key)) {
+        ++NumCacheHits;
+        return Object;
+      }
+    }
+
+    // Keep the lock, if we got it, until the object has been stored.
+    Lock.swap(EntryLock);
+  }
+
+  ++NumCacheMisses;
+  PendingKey.swap(Key);
+  return 0;
+}
+
+void DiskObjectCache::notifyObjectCompiled(const Module *M,
+                                           const MemoryBuffer *Obj) {
+  std::string Key;
+  Key.swap(PendingKey);
+  if (Key.empty())
+    Key = getKey(M);
+
+  // Failing to store an entry only costs a later run the chance to reuse it.
+  std::string ErrMsg;
+  Cache.store(Key, Obj->getBuffer(), ErrMsg);
+  Lock.reset();
+}
@@ -0,0 +1,58 @@
+//===- DiskObjectCache.h - On-disk cache of MCJIT object files --*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares an ObjectCache that keeps MCJIT object files in a
+// directory, so that later runs of the same module skip code generation.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLI_DISKOBJECTCACHE_H
+#define LLI_DISKOBJECTCACHE_H
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileCache.h"
+#include "llvm/Support/LockFileManager.h"
+#include <string>
+
+namespace llvm {
+
+/// DiskObjectCache - An ObjectCache backed by a FileCache.  An entry is keyed
+/// by the LLVM version, the target options and the module's bitcode, so an
+/// object is only reused for the very module and options it was built from.
+///
+/// A LockFileManager lock on the entry keeps concurrent processes from
+/// generating the same object twice.  Large cached objects are handed to
+/// MCJIT as mappings of the cache file rather than read into memory.
+class DiskObjectCache : public ObjectCache {
+  FileCache Cache;
+  std::string TargetKey;
+
+  // Lock on the entry being generated, held from a miss in getObject until
+  // notifyObjectCompiled stores the object.
+  OwningPtr<LockFileManager> Lock;
+  std::string PendingKey;
+
+  std::string getKey(const Module *M) const;
+
+public:
+  /// DiskObjectCache - Create a cache in the directory Dir.  TargetKey must
+  /// describe everything besides the IR that affects the generated code, such
+  /// as the triple, CPU, features and optimization level.
+  DiskObjectCache(StringRef Dir, StringRef TargetKey)
+    : Cache(Dir, "LLVM-MCJIT-CACHE-1"), TargetKey(TargetKey) {}
+
+  virtual void notifyObjectCompiled(const Module *M, const MemoryBuffer *Obj);
+  virtual MemoryBuffer *getObject(const Module *M);
+};
+
+} // End llvm namespace
+
+#endif
@@ -0,0 +1,97 @@
+//===-- llvm-lto.cpp - Drive libLTO from the command line -----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This program links bitcode files through the libLTO C API the way a linker
+// would, and writes the resulting native object file.  It exists to test
+// libLTO.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm-c/lto.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+static cl::list<std::string>
+InputFilenames(cl::Positional, cl::OneOrMore,
+               cl::desc("<input bitcode files>"));
+
+static cl::opt<std::string>
+OutputFilename("o", cl::Required,
+               cl::desc("Override output filename"),
+               cl::value_desc("filename"));
+
+static cl::list<std::string>
+ExportedSymbols("exported-symbol",
+                cl::desc("Symbol to keep visible outside the merged module"),
+                cl::value_desc("symbol"));
+
+static cl::opt<std::string>
+CacheDir("cache-dir",
+         cl::desc("Directory in which libLTO caches object files"),
+         cl::value_desc("directory"));
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  sys::PrintStackTraceOnErrorSignal();
+  PrettyStackTraceProgram X(argc, argv);
+
+  llvm_shutdown_obj Y;  // Call llvm_shutdown() on exit.
+  cl::ParseCommandLineOptions(argc, argv, "llvm LTO driver\n");
+
+  lto_code_gen_t CodeGen = lto_codegen_create();
+  lto_codegen_set_pic_model(CodeGen, LTO_CODEGEN_PIC_MODEL_DYNAMIC);
+  if (!CacheDir.empty())
+    lto_codegen_set_cache_dir(CodeGen, CacheDir.c_str());
+
+  for (unsigned i = 0, e = InputFilenames.size(); i != e; ++i) {
+    lto_module_t Module = lto_module_create(InputFilenames[i].c_str());
+    if (!Module) {
+      errs() << argv[0] << ": error loading file '" << InputFilenames[i]
+             << "': " << lto_get_error_message() << "\n";
+      return 1;
+    }
+    bool Failed = lto_codegen_add_module(CodeGen, Module);
+    lto_module_dispose(Module);
+    if (Failed) {
+      errs() << argv[0] << ": error adding file '" << InputFilenames[i]
+             << "': " << lto_get_error_message() << "\n";
+      return 1;
+    }
+  }
+
+  for (unsigned i = 0, e = ExportedSymbols.size(); i != e; ++i)
+    lto_codegen_add_must_preserve_symbol(CodeGen, ExportedSymbols[i].c_str());
+
+  size_t Length;
+  const char *Object = (const char *)lto_codegen_compile(CodeGen, &Length);
+  if (!Object) {
+    errs() << argv[0] << ": error compiling the code: "
+           << lto_get_error_message() << "\n";
+    return 1;
+  }
+
+  std::string ErrorInfo;
+  tool_output_file Out(OutputFilename.c_str(), ErrorInfo,
+                       raw_fd_ostream::F_Binary);
+  if (!ErrorInfo.empty()) {
+    errs() << argv[0] << ": error opening the file '" << OutputFilename
+           << "': " << ErrorInfo << "\n";
+    return 1;
+  }
+  Out.os().write(Object, Length);
+  Out.keep();
+
+  lto_codegen_dispose(CodeGen);
+  return 0;
+}
@@ -235,7 +235,9 @@ static void SortAndPrintSymbolList() {
 }
 
 static char TypeCharForSymbol(GlobalValue &GV) {
-  if (GV.isDeclaration())                                  return 'U';
+  // Bitcode modules are loaded lazily, so a function whose body has not been
+  // read yet is still a definition.
+  if (GV.isDeclaration() && !GV.isMaterializable())        return 'U';
   if (GV.hasLinkOnceLinkage())                             return 'C';
   if (GV.hasCommonLinkage())                               return 'C';
   if (GV.hasWeakLinkage())                                 return 'W';
@@ -328,9 +330,11 @@ static void DumpSymbolNamesFromFile(std::string &Filename) {
   LLVMContext &Context = getGlobalContext();
   std::string ErrorMessage;
   if (magic == sys::fs::file_magic::bitcode) {
-    Module *Result = 0;
-    Result = ParseBitcodeFile(Buffer.get(), Context, &ErrorMessage);
+    // Only the symbols are needed, so don't parse any function bodies.
+    Module *Result = getLazyBitcodeModule(Buffer.get(), Context,
+                                          &ErrorMessage);
     if (Result) {
+      Buffer.take(); // The module owns the buffer now.
       DumpSymbolNamesFromModule(Result);
       delete Result;
     } else {
@@ -351,9 +355,10 @@ static void DumpSymbolNamesFromFile(std::string &Filename) {
           OwningPtr<MemoryBuffer> buff(i->getBuffer());
           Module *Result = 0;
           if (buff)
-            Result = ParseBitcodeFile(buff.get(), Context, &ErrorMessage);
+            Result = getLazyBitcodeModule(buff.get(), Context, &ErrorMessage);
 
           if (Result) {
+            buff.take(); // The module owns the buffer now.
             DumpSymbolNamesFromModule(Result);
             delete Result;
           }
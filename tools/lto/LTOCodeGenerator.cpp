@@ -12,6 +12,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#define DEBUG_TYPE "lto"
 #include "LTOCodeGenerator.h"
 #include "LTOModule.h"
 #include "llvm/Constants.h"
@@ -35,7 +36,10 @@
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileCache.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormattedStream.h"
+#include "llvm/Support/LockFileManager.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/Host.h"
@@ -43,15 +47,22 @@
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/system_error.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 using namespace llvm;
 
+STATISTIC(NumCacheHits,   "Number of native objects reused from the LTO cache");
+STATISTIC(NumCacheMisses, "Number of native objects missing from the LTO cache");
+
 static cl::opt<bool> DisableInline("disable-inlining", cl::init(false),
   cl::desc("Do not run the inliner pass"));
 
 static cl::opt<bool> DisableGVNLoadPRE("disable-gvn-loadpre", cl::init(false),
   cl::desc("Do not run the GVN load PRE pass"));
 
+static cl::opt<unsigned> CacheMaxSize("lto-cache-max-size", cl::init(0),
+  cl::desc("Prune the LTO cache down to this many megabytes (0 = no limit)"));
+
 const char* LTOCodeGenerator::getVersionString() {
 #ifdef LLVM_VERSION_INFO
   return PACKAGE_NAME " version " PACKAGE_VERSION ", " LLVM_VERSION_INFO;
@@ -337,8 +348,6 @@ bool LTOCodeGenerator::generateObjectFile(raw_ostream &out,
   if ( this->determineTarget(errMsg) )
     return true;
 
-  Module* mergedModule = _linker.getModule();
-
   // if options were requested, set them
   if ( !_codegenOptions.empty() )
     cl::ParseCommandLineOptions(_codegenOptions.size(),
@@ -347,6 +356,83 @@ bool LTOCodeGenerator::generateObjectFile(raw_ostream &out,
   // mark which symbols can not be internalized
   this->applyScopeRestrictions();
 
+  if ( !_cacheDir.empty() )
+    return this->generateCachedObjectFile(out, errMsg);
+  return this->emitObjectFile(out, errMsg);
+}
+
+/// getCacheKey - Return the LTO cache key for the merged module, covering its
+/// bitcode and everything else that affects the generated object file.
+std::string LTOCodeGenerator::getCacheKey() {
+  std::string data;
+  raw_string_ostream os(data);
+  os << getVersionString() << '\0'
+     << _target->getTargetTriple() << '\0'
+     << _target->getTargetCPU() << '\0'
+     << _target->getTargetFeatureString() << '\0'
+     << _codeModel << '\0'
+     << (_emitDwarfDebugInfo ? '1' : '0')
+     << (DisableInline ? '1' : '0')
+     << (DisableGVNLoadPRE ? '1' : '0') << '\0';
+  for (unsigned i = 0, e = _codegenOptions.size(); i != e; ++i)
+    os << _codegenOptions[i] << '\0';
+  WriteBitcodeToFile(_linker.getModule(), os);
+  os.flush();
+  return FileCache::getKey(data);
+}
+
+/// generateCachedObjectFile - Like emitObjectFile, but reuse the object file
+/// from the cache directory if the merged module and options are unchanged.
+/// Problems with the cache itself are not fatal; they just disable it.
+bool LTOCodeGenerator::generateCachedObjectFile(raw_ostream &out,
+                                                std::string &errMsg) {
+  bool existed;
+  if (sys::fs::create_directories(_cacheDir, existed))
+    return this->emitObjectFile(out, errMsg);
+
+  FileCache cache(_cacheDir, "LLVM-LTO-CACHE-2");
+  std::string key = this->getCacheKey();
+
+  OwningPtr<MemoryBuffer> cached(cache.lookup(key));
+  if (cached) {
+    ++NumCacheHits;
+    out << cached->getBuffer();
+    return false;
+  }
+
+  // Another linker may be producing the same entry; if so, wait for it
+  // rather than doing the same work twice.
+  LockFileManager locked(cache.getEntryPath(key));
+  if (locked.getState() == LockFileManager::LFS_Shared) {
+    locked.waitForUnlock();
+    cached.reset(cache.lookup(key));
+    if (cached) {
+      ++NumCacheHits;
+      out << cached->getBuffer();
+      return false;
+    }
+  }
+
+  ++NumCacheMisses;
+  std::string object;
+  raw_string_ostream objectOut(object);
+  if (this->emitObjectFile(objectOut, errMsg))
+    return true;
+  objectOut.flush();
+
+  std::string cacheErrMsg;
+  if (!cache.store(key, object, cacheErrMsg) && CacheMaxSize != 0)
+    cache.prune(uint64_t(CacheMaxSize) * 1024 * 1024);
+
+  out << object;
+  return false;
+}
+
+/// emitObjectFile - Run the LTO passes over the merged module and generate
+/// its native object file.
+bool LTOCodeGenerator::emitObjectFile(raw_ostream &out, std::string &errMsg) {
+  Module* mergedModule = _linker.getModule();
+
   // Instantiate the pass manager to organize the passes.
   PassManager passes;
 
@@ -44,6 +44,7 @@ struct LTOCodeGenerator {
   bool setCodePICModel(lto_codegen_model, std::string &errMsg);
 
   void setCpu(const char* mCpu) { _mCpu = mCpu; }
+  void setCacheDir(const char* dir) { _cacheDir = dir ? dir : ""; }
 
   void addMustPreserveSymbol(const char* sym) {
     _mustPreserveSymbols[sym] = 1;
@@ -56,6 +57,9 @@ struct LTOCodeGenerator {
 
 private:
   bool generateObjectFile(llvm::raw_ostream &out, std::string &errMsg);
+  bool generateCachedObjectFile(llvm::raw_ostream &out, std::string &errMsg);
+  bool emitObjectFile(llvm::raw_ostream &out, std::string &errMsg);
+  std::string getCacheKey();
   void applyScopeRestrictions();
   void applyRestriction(llvm::GlobalValue &GV,
                         std::vector<const char*> &mustPreserveList,
@@ -77,6 +81,7 @@ private:
   std::vector<char*>          _codegenOptions;
   std::string                 _mCpu;
   std::string                 _nativeObjectPath;
+  std::string                 _cacheDir;
 };
 
 #endif // LTO_CODE_GENERATOR_H
@@ -163,6 +163,12 @@ void lto_codegen_set_cpu(lto_code_gen_t cg, const char *cpu) {
   return cg->setCpu(cpu);
 }
 
+/// lto_codegen_set_cache_dir - Sets the directory used to cache generated
+/// object files.
+void lto_codegen_set_cache_dir(lto_code_gen_t cg, const char *dir) {
+  return cg->setCacheDir(dir);
+}
+
 /// lto_codegen_set_assembler_path - Sets the path to the assembler tool.
 void lto_codegen_set_assembler_path(lto_code_gen_t cg, const char *path) {
   // In here only for backwards compatibility. We use MC now.
@@ -0,0 +1,123 @@
+//===- PerfJITEventListenerTest.cpp - Tests for PerfJITEventListener ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITEventListener.h"
+
+#include "llvm/LLVMContext.h"
+#include "llvm/Instructions.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ExecutionEngine/JIT.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TypeBuilder.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+using namespace llvm;
+
+namespace {
+
+Function *buildIdentity(Module *M, StringRef Name) {
+  Function *Result = Function::Create(
+      TypeBuilder<int32_t(int32_t), false>::get(getGlobalContext()),
+      GlobalValue::ExternalLinkage, Name, M);
+  Value *Arg = Result->arg_begin();
+  BasicBlock *BB = BasicBlock::Create(M->getContext(), "entry", Result);
+  ReturnInst::Create(M->getContext(), Arg, BB);
+  return Result;
+}
+
+// Returns the size recorded for Name at Addr, or 0 if the map has no such
+// entry.
+unsigned long findMapEntry(const std::string &Map, void *Addr,
+                           StringRef Name) {
+  SmallVector<StringRef, 8> Lines;
+  StringRef(Map).split(Lines, "\n", -1, false);
+  for (unsigned i = 0, e = Lines.size(); i != e; ++i) {
+    std::pair<StringRef, StringRef> Start = Lines[i].split(' ');
+    std::pair<StringRef, StringRef> Size = Start.second.split(' ');
+    unsigned long long StartVal, SizeVal;
+    if (Start.first.getAsInteger(16, StartVal) ||
+        Size.first.getAsInteger(16, SizeVal))
+      continue;
+    if (StartVal == (uintptr_t)Addr && Size.second == Name)
+      return SizeVal;
+  }
+  return 0;
+}
+
+class PerfJITEventListenerTest : public testing::Test {
+protected:
+  virtual void SetUp() {
+    InitializeNativeTarget();
+    M = new Module("module", getGlobalContext());
+    EE.reset(EngineBuilder(M).setEngineKind(EngineKind::JIT).create());
+  }
+
+  Module *M;  // Owned by EE.
+  OwningPtr<ExecutionEngine> EE;
+};
+
+TEST_F(PerfJITEventListenerTest, WritesMapEntries) {
+  ASSERT_TRUE(EE.get() != 0);
+
+  std::string Map;
+  raw_string_ostream MapOS(Map);
+  OwningPtr<JITEventListener> Listener(
+    JITEventListener::createPerfJITEventListener(MapOS));
+  EE->RegisterJITEventListener(Listener.get());
+
+  Function *F1 = buildIdentity(M, "first");
+  Function *F2 = buildIdentity(M, "second");
+  void *F1Addr = EE->getPointerToFunction(F1);
+  void *F2Addr = EE->getPointerToFunction(F2);
+
+  EE->getPointerToFunction(F1);  // Should do nothing.
+
+  // The entries are batched rather than written one at a time.
+  EXPECT_LT(0U, MapOS.GetNumBytesInBuffer());
+
+  // Destroying the listener writes out whatever it has buffered.
+  EE->UnregisterJITEventListener(Listener.get());
+  Listener.reset();
+  EXPECT_EQ(0U, MapOS.GetNumBytesInBuffer());
+
+  MapOS.flush();
+  EXPECT_EQ(2, std::count(Map.begin(), Map.end(), '\n')) << Map;
+  EXPECT_LT(0UL, findMapEntry(Map, F1Addr, "first")) << Map;
+  EXPECT_LT(0UL, findMapEntry(Map, F2Addr, "second")) << Map;
+
+  F1->eraseFromParent();
+  F2->eraseFromParent();
+}
+
+TEST_F(PerfJITEventListenerTest, FlushEachEntry) {
+  ASSERT_TRUE(EE.get() != 0);
+
+  std::string Map;
+  raw_string_ostream MapOS(Map);
+  OwningPtr<JITEventListener> Listener(
+    JITEventListener::createPerfJITEventListener(MapOS, true));
+  EE->RegisterJITEventListener(Listener.get());
+
+  Function *F = buildIdentity(M, "first");
+  void *FAddr = EE->getPointerToFunction(F);
+
+  // The entry reaches the file before the listener goes away, as perf top
+  // needs.
+  EXPECT_EQ(0U, MapOS.GetNumBytesInBuffer());
+  EXPECT_LT(0UL, findMapEntry(Map, FAddr, "first")) << Map;
+
+  EE->UnregisterJITEventListener(Listener.get());
+  F->eraseFromParent();
+}
+
+} // anonymous namespace
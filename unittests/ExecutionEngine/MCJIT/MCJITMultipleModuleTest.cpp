@@ -0,0 +1,217 @@
+//===- MCJITMultipleModuleTest.cpp - Unit tests for lazy module emission --===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Assembly/Parser.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/Support/Memory.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+namespace {
+
+// MCJIT only loads ELF objects for x86 and x86-64 reliably so far.
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+
+Module *loadModule(LLVMContext &Context, const char *Name,
+                   const char *Assembly) {
+  Module *M = new Module(Name, Context);
+  SMDiagnostic Error;
+  bool Success = ParseAssemblyString(Assembly, M, Error, Context) != 0;
+  std::string ErrMsg;
+  raw_string_ostream OS(ErrMsg);
+  Error.print("", OS);
+  EXPECT_TRUE(Success) << OS.str();
+  return M;
+}
+
+// Emitting a module after another one has run must not re-apply the
+// relocations of the first: most of them add to what is already in the code.
+TEST(MCJITMultipleModuleTest, EmitAfterRun) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+
+  LLVMContext Context;
+  Module *A = loadModule(Context, "A",
+                         "@g = global i32 5 "
+                         "define i32 @getA() { "
+                         "  %v = load i32* @g "
+                         "  ret i32 %v "
+                         "} ");
+  Module *B = loadModule(Context, "B",
+                         "@h = global i32 1 "
+                         "declare i32 @getA() "
+                         "define i32 @getB() { "
+                         "  %a = call i32 @getA() "
+                         "  %h = load i32* @h "
+                         "  %r = add i32 %a, %h "
+                         "  ret i32 %r "
+                         "} ");
+
+  std::string Error;
+  OwningPtr<ExecutionEngine> EE(EngineBuilder(A)
+                                .setEngineKind(EngineKind::JIT)
+                                .setUseMCJIT(true)
+                                .setErrorStr(&Error)
+                                .create());
+  ASSERT_TRUE(EE.get() != 0) << Error;
+
+  int (*GetA)() = (int(*)())(intptr_t)
+    EE->getPointerToFunction(A->getFunction("getA"));
+  ASSERT_TRUE(GetA != 0);
+  EXPECT_EQ(5, GetA());
+
+  EE->addModule(B);
+  int (*GetB)() = (int(*)())(intptr_t)
+    EE->getPointerToFunction(B->getFunction("getB"));
+  ASSERT_TRUE(GetB != 0);
+  EXPECT_EQ(6, GetB());
+
+  EXPECT_EQ(5, GetA());
+  EXPECT_EQ(GetA, (int(*)())(intptr_t)
+            EE->getPointerToFunction(B->getFunction("getA")));
+}
+
+// A removed module no longer provides definitions to the others.
+TEST(MCJITMultipleModuleTest, RemoveModule) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+
+  LLVMContext Context;
+  Module *A = loadModule(Context, "A",
+                         "define i32 @f() { "
+                         "  ret i32 1 "
+                         "} ");
+  Module *B = loadModule(Context, "B",
+                         "define i32 @f() { "
+                         "  ret i32 2 "
+                         "} ");
+  Module *C = loadModule(Context, "C",
+                         "declare i32 @f() "
+                         "define i32 @useF() { "
+                         "  %r = call i32 @f() "
+                         "  ret i32 %r "
+                         "} ");
+
+  std::string Error;
+  OwningPtr<ExecutionEngine> EE(EngineBuilder(A)
+                                .setEngineKind(EngineKind::JIT)
+                                .setUseMCJIT(true)
+                                .setErrorStr(&Error)
+                                .create());
+  ASSERT_TRUE(EE.get() != 0) << Error;
+  EE->addModule(B);
+  EE->addModule(C);
+
+  // A was added first, so it provides @f until it is removed.
+  EXPECT_TRUE(EE->removeModule(A));
+  delete A;
+
+  int (*UseF)() = (int(*)())(intptr_t)
+    EE->getPointerToFunction(C->getFunction("useF"));
+  ASSERT_TRUE(UseF != 0);
+  EXPECT_EQ(2, UseF());
+}
+
+// Leaves code writable after finalization, so that relocations can be
+// re-resolved when a section is remapped, and records the data sections.
+class RemapMemoryManager : public SectionMemoryManager {
+  SmallVector<sys::MemoryBlock, 4> Code;
+
+public:
+  SmallVector<sys::MemoryBlock, 4> Data;
+
+  virtual uint8_t *allocateCodeSection(uintptr_t Size, unsigned Alignment,
+                                       unsigned SectionID) {
+    uint8_t *Addr =
+      SectionMemoryManager::allocateCodeSection(Size, Alignment, SectionID);
+    Code.push_back(sys::MemoryBlock(Addr, Size));
+    return Addr;
+  }
+
+  virtual uint8_t *allocateDataSection(uintptr_t Size, unsigned Alignment,
+                                       unsigned SectionID) {
+    uint8_t *Addr =
+      SectionMemoryManager::allocateDataSection(Size, Alignment, SectionID);
+    Data.push_back(sys::MemoryBlock(Addr, Size));
+    return Addr;
+  }
+
+  virtual void finalizeMemory() {
+    SectionMemoryManager::finalizeMemory();
+    uintptr_t PageSize = sys::Process::GetPageSize();
+    for (unsigned i = 0, e = Code.size(); i != e; ++i) {
+      uintptr_t Start = (uintptr_t)Code[i].base() & ~(PageSize - 1);
+      uintptr_t End = (uintptr_t)Code[i].base() + Code[i].size();
+      sys::Memory::protectMappedMemory(
+        sys::MemoryBlock((void*)Start, End - Start),
+        sys::Memory::MF_READ | sys::Memory::MF_WRITE | sys::Memory::MF_EXEC);
+    }
+  }
+};
+
+// Remapping a section after its relocations have been resolved re-resolves
+// them, as remote-target clients that copy sections elsewhere rely on.
+TEST(MCJITMultipleModuleTest, RemapSectionAfterRun) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+
+  LLVMContext Context;
+  Module *M = loadModule(Context, "M",
+                         "@g = global i32 305419896 "
+                         "define i32 @get() { "
+                         "  %v = load i32* @g "
+                         "  ret i32 %v "
+                         "} ");
+
+  RemapMemoryManager *MM = new RemapMemoryManager();
+  std::string Error;
+  OwningPtr<ExecutionEngine> EE(EngineBuilder(M)
+                                .setEngineKind(EngineKind::JIT)
+                                .setUseMCJIT(true)
+                                .setJITMemoryManager(MM)
+                                .setErrorStr(&Error)
+                                .create());
+  ASSERT_TRUE(EE.get() != 0) << Error;
+
+  int (*Get)() = (int(*)())(intptr_t)
+    EE->getPointerToFunction(M->getFunction("get"));
+  ASSERT_TRUE(Get != 0);
+  EXPECT_EQ(0x12345678, Get());
+
+  // Find the section holding @g and move a modified copy of it elsewhere.
+  int32_t *Old = 0;
+  for (unsigned i = 0, e = MM->Data.size(); i != e; ++i)
+    if (MM->Data[i].size() >= 4 &&
+        *(int32_t*)MM->Data[i].base() == 0x12345678)
+      Old = (int32_t*)MM->Data[i].base();
+  ASSERT_TRUE(Old != 0);
+  int32_t *New = (int32_t*)MM->allocateDataSection(4, 4, 1000);
+  *New = 42;
+
+  EE->mapSectionAddress(Old, (uint64_t)(uintptr_t)New);
+  EXPECT_EQ(42, Get());
+
+  // Mapping it back restores the original binding.
+  EE->mapSectionAddress(Old, (uint64_t)(uintptr_t)Old);
+  EXPECT_EQ(0x12345678, Get());
+}
+
+#endif
+
+}
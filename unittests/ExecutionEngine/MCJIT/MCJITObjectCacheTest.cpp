@@ -0,0 +1,104 @@
+//===- MCJITObjectCacheTest.cpp - Unit tests for the MCJIT ObjectCache ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Assembly/Parser.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+
+using namespace llvm;
+
+namespace {
+
+// MCJIT only loads ELF objects for x86 and x86-64 reliably so far.
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+
+// Holds on to the last object compiled, and returns it for every module.
+class TestObjectCache : public ObjectCache {
+public:
+  OwningPtr<MemoryBuffer> Object;
+  unsigned NumCompiled;
+  unsigned NumLookups;
+
+  TestObjectCache() : NumCompiled(0), NumLookups(0) {}
+
+  virtual void notifyObjectCompiled(const Module *M, const MemoryBuffer *Obj) {
+    ++NumCompiled;
+    Object.reset(MemoryBuffer::getMemBufferCopy(Obj->getBuffer()));
+  }
+
+  virtual MemoryBuffer *getObject(const Module *M) {
+    ++NumLookups;
+    if (!Object)
+      return 0;
+    return MemoryBuffer::getMemBufferCopy(Object->getBuffer());
+  }
+};
+
+const char *Assembly = "@g = global i32 40 "
+                       "define i32 @f() { "
+                       "  %v = load i32* @g "
+                       "  %r = add i32 %v, 2 "
+                       "  ret i32 %r "
+                       "} ";
+
+Module *loadModule(LLVMContext &Context) {
+  Module *M = new Module("cached", Context);
+  SMDiagnostic Error;
+  EXPECT_TRUE(ParseAssemblyString(Assembly, M, Error, Context) != 0);
+  return M;
+}
+
+int runWithCache(ObjectCache *Cache) {
+  LLVMContext Context;
+  Module *M = loadModule(Context);
+  std::string Error;
+  OwningPtr<ExecutionEngine> EE(EngineBuilder(M)
+                                .setEngineKind(EngineKind::JIT)
+                                .setUseMCJIT(true)
+                                .setErrorStr(&Error)
+                                .create());
+  EXPECT_TRUE(EE.get() != 0) << Error;
+  if (!EE)
+    return -1;
+  EE->setObjectCache(Cache);
+
+  int (*F)() = (int(*)())(intptr_t)
+    EE->getPointerToFunction(M->getFunction("f"));
+  EXPECT_TRUE(F != 0);
+  return F ? F() : -1;
+}
+
+// The first engine compiles the module and hands the object to the cache; a
+// second engine loads that object instead of generating code.
+TEST(MCJITObjectCacheTest, ReuseCompiledObject) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+
+  TestObjectCache Cache;
+  EXPECT_EQ(42, runWithCache(&Cache));
+  EXPECT_EQ(1U, Cache.NumLookups);
+  EXPECT_EQ(1U, Cache.NumCompiled);
+  ASSERT_TRUE(Cache.Object != 0);
+
+  EXPECT_EQ(42, runWithCache(&Cache));
+  EXPECT_EQ(2U, Cache.NumLookups);
+  EXPECT_EQ(1U, Cache.NumCompiled);
+}
+
+#endif
+
+}
@@ -0,0 +1,129 @@
+//===- SectionMemoryManagerTest.cpp - MCJIT memory manager unit tests ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/Support/Process.h"
+#include <cstring>
+
+using namespace llvm;
+
+namespace {
+
+TEST(SectionMemoryManagerTest, BasicAllocations) {
+  OwningPtr<SectionMemoryManager> MemMgr(new SectionMemoryManager());
+
+  uint8_t *Code1 = MemMgr->allocateCodeSection(256, 0, 1);
+  uint8_t *Data1 = MemMgr->allocateDataSection(256, 0, 2);
+  uint8_t *Code2 = MemMgr->allocateCodeSection(256, 0, 3);
+  uint8_t *Data2 = MemMgr->allocateDataSection(256, 0, 4);
+
+  EXPECT_NE((uint8_t*)0, Code1);
+  EXPECT_NE((uint8_t*)0, Data1);
+  EXPECT_NE((uint8_t*)0, Code2);
+  EXPECT_NE((uint8_t*)0, Data2);
+
+  // Everything has to be writable until the code is made executable.
+  memset(Code1, 0xC3, 256);
+  memset(Code2, 0xC3, 256);
+  memset(Data1, 1, 256);
+  memset(Data2, 2, 256);
+
+  // Code and data live in separate slabs.
+  SectionMemoryManager::MemoryUsage Usage = MemMgr->getMemoryUsage();
+  EXPECT_EQ(1U, Usage.NumCodeSlabs);
+  EXPECT_EQ(1U, Usage.NumDataSlabs);
+  EXPECT_EQ(512U, Usage.CodeBytesUsed);
+  EXPECT_EQ(512U, Usage.DataBytesUsed);
+  EXPECT_LE(Usage.CodeBytesUsed, Usage.CodeBytesReserved);
+  EXPECT_LE(Usage.DataBytesUsed, Usage.DataBytesReserved);
+
+  MemMgr->finalizeMemory();
+
+  // Data stays writable, and the code is left alone.
+  memset(Data1, 3, 256);
+  for (unsigned i = 0; i != 256; ++i)
+    EXPECT_EQ(0xC3, Code1[i]);
+}
+
+TEST(SectionMemoryManagerTest, Alignment) {
+  OwningPtr<SectionMemoryManager> MemMgr(new SectionMemoryManager());
+
+  MemMgr->allocateCodeSection(3, 0, 1);
+  uint8_t *Code = MemMgr->allocateCodeSection(16, 64, 2);
+  EXPECT_EQ(0U, (uintptr_t)Code & 63);
+
+  MemMgr->allocateDataSection(5, 1, 3);
+  uint8_t *Data = MemMgr->allocateDataSection(16, 256, 4);
+  EXPECT_EQ(0U, (uintptr_t)Data & 255);
+}
+
+TEST(SectionMemoryManagerTest, LargeSections) {
+  const size_t SlabSize = 64 * 1024;
+  OwningPtr<SectionMemoryManager> MemMgr(new SectionMemoryManager(SlabSize));
+
+  uint8_t *Small1 = MemMgr->allocateCodeSection(128, 0, 1);
+  uint8_t *Large = MemMgr->allocateCodeSection(4 * SlabSize, 0, 2);
+  uint8_t *Small2 = MemMgr->allocateCodeSection(128, 0, 3);
+  memset(Large, 0, 4 * SlabSize);
+
+  // The large section gets a slab of its own, and the small ones keep
+  // sharing the first slab.
+  EXPECT_EQ(2U, MemMgr->GetNumCodeSlabs());
+  EXPECT_GE(Small2, Small1 + 128);
+  EXPECT_LT(Small2, Small1 + SlabSize);
+
+  // Filling up the current slab starts a new one.
+  for (unsigned i = 0; i != 16; ++i)
+    MemMgr->allocateCodeSection(SlabSize / 8, 0, 4 + i);
+  EXPECT_LT(2U, MemMgr->GetNumCodeSlabs());
+}
+
+TEST(SectionMemoryManagerTest, WriteAfterExecutable) {
+  OwningPtr<SectionMemoryManager> MemMgr(new SectionMemoryManager(4096, true));
+
+  uint8_t *Code1 = MemMgr->allocateCodeSection(64, 0, 1);
+  memset(Code1, 0xC3, 64);
+  MemMgr->finalizeMemory();
+
+  // A new code section can be written even though the slab it is carved out
+  // of has already been made executable.
+  uint8_t *Code2 = MemMgr->allocateCodeSection(64, 0, 2);
+  memset(Code2, 0xC3, 64);
+  MemMgr->finalizeMemory();
+  EXPECT_EQ(0xC3, Code1[63]);
+  EXPECT_EQ(0xC3, Code2[63]);
+}
+
+TEST(SectionMemoryManagerTest, FinalizeOnlyNewCode) {
+  OwningPtr<SectionMemoryManager> MemMgr(new SectionMemoryManager());
+  uintptr_t PageMask = ~(uintptr_t)(sys::Process::GetPageSize() - 1);
+
+  uint8_t *Code1 = MemMgr->allocateCodeSection(64, 0, 1);
+  memset(Code1, 0xC3, 64);
+  MemMgr->finalizeMemory();
+
+  // Code allocated after finalizeMemory() shares no page with the code that
+  // is executable now, but still comes out of the same slab.
+  uint8_t *Code2 = MemMgr->allocateCodeSection(64, 0, 2);
+  uint8_t *Code3 = MemMgr->allocateCodeSection(64, 0, 3);
+  EXPECT_NE((uintptr_t)Code1 & PageMask, (uintptr_t)Code2 & PageMask);
+  EXPECT_EQ(1U, MemMgr->GetNumCodeSlabs());
+  memset(Code2, 0xC3, 64);
+  memset(Code3, 0xC3, 64);
+  MemMgr->finalizeMemory();
+  EXPECT_EQ(0xC3, Code1[0]);
+  EXPECT_EQ(0xC3, Code3[63]);
+
+  // Finalizing again with nothing new is harmless.
+  MemMgr->finalizeMemory();
+}
+
+}
@@ -0,0 +1,122 @@
+//===- llvm/unittest/Support/FileCacheTest.cpp - FileCache tests ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements unit tests for FileCache.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/FileCache.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+class FileCacheTest : public testing::Test {
+protected:
+  sys::Path Dir;
+
+  virtual void SetUp() {
+    Dir = sys::Path::GetTemporaryDirectory();
+    ASSERT_FALSE(Dir.isEmpty());
+  }
+
+  virtual void TearDown() {
+    Dir.eraseFromDisk(true);
+  }
+
+  void overwriteEntry(FileCache &Cache, StringRef Key, StringRef Contents) {
+    std::string ErrMsg;
+    raw_fd_ostream OS(Cache.getEntryPath(Key).c_str(), ErrMsg,
+                      raw_fd_ostream::F_Binary);
+    ASSERT_TRUE(ErrMsg.empty()) << ErrMsg;
+    OS << Contents;
+  }
+};
+
+TEST_F(FileCacheTest, Keys) {
+  EXPECT_EQ("d41d8cd98f00b204e9800998ecf8427e", FileCache::getKey(""));
+  EXPECT_NE(FileCache::getKey("a"), FileCache::getKey("b"));
+}
+
+TEST_F(FileCacheTest, StoreAndLookup) {
+  FileCache Cache(Dir.str(), "TEST-1");
+  std::string Key = FileCache::getKey("small");
+  EXPECT_EQ(0, Cache.lookup(Key));
+
+  std::string ErrMsg;
+  ASSERT_FALSE(Cache.store(Key, "data", ErrMsg)) << ErrMsg;
+  OwningPtr<MemoryBuffer> Data(Cache.lookup(Key));
+  ASSERT_TRUE(Data != 0);
+  EXPECT_EQ("data", Data->getBuffer());
+
+  // Entries written for another kind of cache are not used.
+  FileCache Other(Dir.str(), "TEST-2");
+  EXPECT_EQ(0, Other.lookup(Key));
+}
+
+// Large entries are mapped starting just past the header.
+TEST_F(FileCacheTest, LargeEntry) {
+  FileCache Cache(Dir.str(), "TEST-1");
+  std::string Key = FileCache::getKey("large");
+  std::string Contents;
+  for (unsigned i = 0; i != 100000; ++i)
+    Contents += char('a' + i % 26);
+
+  std::string ErrMsg;
+  ASSERT_FALSE(Cache.store(Key, Contents, ErrMsg)) << ErrMsg;
+  OwningPtr<MemoryBuffer> Data(Cache.lookup(Key));
+  ASSERT_TRUE(Data != 0);
+  EXPECT_EQ(MemoryBuffer::MemoryBuffer_MMap, Data->getBufferKind());
+  EXPECT_EQ(Contents, Data->getBuffer().str());
+}
+
+TEST_F(FileCacheTest, RejectDamagedEntries) {
+  FileCache Cache(Dir.str(), "TEST-1");
+  std::string Key = FileCache::getKey("damaged");
+  std::string ErrMsg;
+  ASSERT_FALSE(Cache.store(Key, "data", ErrMsg)) << ErrMsg;
+
+  overwriteEntry(Cache, Key, "TEST-1 " + Key + " 4\ndat");
+  EXPECT_EQ(0, Cache.lookup(Key));
+  overwriteEntry(Cache, Key, "TEST-1 " + FileCache::getKey("x") + " 4\ndata");
+  EXPECT_EQ(0, Cache.lookup(Key));
+  overwriteEntry(Cache, Key, "TEST-1 " + Key + " 4");
+  EXPECT_EQ(0, Cache.lookup(Key));
+  overwriteEntry(Cache, Key, "TEST-1 " + Key + " 4\ndata");
+  OwningPtr<MemoryBuffer> Data(Cache.lookup(Key));
+  ASSERT_TRUE(Data != 0);
+  EXPECT_EQ("data", Data->getBuffer());
+}
+
+TEST_F(FileCacheTest, Prune) {
+  FileCache Cache(Dir.str(), "TEST-1");
+  std::string ErrMsg;
+  std::string Keys[3];
+  for (unsigned i = 0; i != 3; ++i) {
+    Keys[i] = FileCache::getKey(std::string(1, char('a' + i)));
+    ASSERT_FALSE(Cache.store(Keys[i], std::string(1000, 'x'), ErrMsg));
+  }
+
+  // Each entry is a little over 1000 bytes, so only one fits.
+  Cache.prune(1500);
+  unsigned Remaining = 0;
+  for (unsigned i = 0; i != 3; ++i) {
+    OwningPtr<MemoryBuffer> Data(Cache.lookup(Keys[i]));
+    Remaining += Data != 0;
+  }
+  EXPECT_EQ(1U, Remaining);
+}
+
+}
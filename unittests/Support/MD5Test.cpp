@@ -0,0 +1,62 @@
+//===- llvm/unittest/Support/MD5Test.cpp - MD5 tests ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements unit tests for the MD5 functions.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/MD5.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+std::string digest(StringRef Input) {
+  MD5 Hash;
+  Hash.update(Input);
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  SmallString<32> Str;
+  MD5::stringifyResult(Result, Str);
+  return Str.str();
+}
+
+TEST(MD5Test, RFC1321) {
+  EXPECT_EQ("d41d8cd98f00b204e9800998ecf8427e", digest(""));
+  EXPECT_EQ("0cc175b9c0f1b6a831c399e269772661", digest("a"));
+  EXPECT_EQ("900150983cd24fb0d6963f7d28e17f72", digest("abc"));
+  EXPECT_EQ("f96b697d7cb7938d525a2f31aaf161d0", digest("message digest"));
+  EXPECT_EQ("57edf4a22be3c955ac49da2e2107b67a",
+            digest("1234567890123456789012345678901234567890"
+                   "1234567890123456789012345678901234567890"));
+}
+
+TEST(MD5Test, Incremental) {
+  // Splitting the input anywhere, including across block boundaries, gives
+  // the same digest.
+  std::string Input;
+  for (unsigned i = 0; i != 300; ++i)
+    Input += char('a' + i % 26);
+  std::string Expected = digest(Input);
+
+  for (unsigned Split = 0; Split <= Input.size(); Split += 7) {
+    MD5 Hash;
+    Hash.update(StringRef(Input).substr(0, Split));
+    Hash.update(StringRef(Input).substr(Split));
+    MD5::MD5Result Result;
+    Hash.final(Result);
+    SmallString<32> Str;
+    MD5::stringifyResult(Result, Str);
+    EXPECT_EQ(Expected, Str.str().str());
+  }
+}
+
+}
@@ -0,0 +1,83 @@
+//===- llvm/unittest/Support/MemoryTest.cpp - Mapped memory tests ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Memory.h"
+#include "llvm/Support/Process.h"
+
+#include "gtest/gtest.h"
+#include <cstring>
+
+using namespace llvm;
+using namespace sys;
+
+namespace {
+
+TEST(MemoryTest, AllocateAndRelease) {
+  std::string Error;
+  unsigned Flags = Memory::MF_READ | Memory::MF_WRITE;
+  MemoryBlock M = Memory::allocateMappedMemory(sizeof(int), Flags, &Error);
+  ASSERT_NE((void*)0, M.base()) << Error;
+  EXPECT_LE(sizeof(int), M.size());
+  EXPECT_EQ(0U, (uintptr_t)M.base() % Process::GetPageSize());
+
+  // Fresh mappings are zeroed.
+  EXPECT_EQ(0, *(int*)M.base());
+  *(int*)M.base() = 42;
+  EXPECT_EQ(42, *(int*)M.base());
+
+  EXPECT_FALSE(Memory::releaseMappedMemory(M, &Error)) << Error;
+  EXPECT_EQ((void*)0, M.base());
+}
+
+TEST(MemoryTest, ZeroSize) {
+  MemoryBlock M = Memory::allocateMappedMemory(0, Memory::MF_READ);
+  EXPECT_EQ((void*)0, M.base());
+  EXPECT_FALSE(Memory::releaseMappedMemory(M));
+}
+
+TEST(MemoryTest, Protect) {
+  std::string Error;
+  unsigned Flags = Memory::MF_READ | Memory::MF_WRITE;
+  MemoryBlock M = Memory::allocateMappedMemory(3 * Process::GetPageSize(),
+                                               Flags, &Error);
+  ASSERT_NE((void*)0, M.base()) << Error;
+  memset(M.base(), 0xAB, M.size());
+
+  // Taking away write access keeps the contents readable.
+  EXPECT_FALSE(Memory::protectMappedMemory(M, Memory::MF_READ, &Error))
+    << Error;
+  EXPECT_EQ(0xAB, ((unsigned char*)M.base())[M.size() - 1]);
+
+  EXPECT_FALSE(Memory::protectMappedMemory(M, Memory::MF_READ |
+                                              Memory::MF_EXEC, &Error))
+    << Error;
+  EXPECT_FALSE(Memory::protectMappedMemory(M, Memory::MF_READ |
+                                              Memory::MF_WRITE, &Error))
+    << Error;
+  ((unsigned char*)M.base())[0] = 0xCD;
+  EXPECT_EQ(0xCD, ((unsigned char*)M.base())[0]);
+
+  EXPECT_FALSE(Memory::releaseMappedMemory(M, &Error)) << Error;
+}
+
+TEST(MemoryTest, HugePagesHint) {
+  // Whether the system honors the hint or not, the result must be usable.
+  std::string Error;
+  MemoryBlock M = Memory::allocateMappedMemory(100,
+                                               Memory::MF_READ |
+                                               Memory::MF_WRITE |
+                                               Memory::MF_HUGE_PAGES,
+                                               &Error);
+  ASSERT_NE((void*)0, M.base()) << Error;
+  EXPECT_LE(100U, M.size());
+  memset(M.base(), 1, M.size());
+  EXPECT_FALSE(Memory::releaseMappedMemory(M, &Error)) << Error;
+}
+
+}
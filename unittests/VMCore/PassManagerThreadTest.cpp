@@ -0,0 +1,143 @@
+//===- llvm/unittest/VMCore/PassManagerThreadTest.cpp - Threaded PM tests -===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Stress test for running independent optimization pipelines concurrently,
+// each thread owning its own LLVMContext.  Run this under tsan to catch races
+// on hidden global state (ManagedStatics, the PassRegistry, statistics...).
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Function.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/PassManager.h"
+#include "llvm/Analysis/Verifier.h"
+#include "llvm/Assembly/Parser.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+#ifdef HAVE_PTHREAD_H
+const char *TestIR =
+  "define internal i32 @square(i32 %x) {\n"
+  "  %r = mul i32 %x, %x\n"
+  "  ret i32 %r\n"
+  "}\n"
+  "define i32 @sum(i32 %n) {\n"
+  "entry:\n"
+  "  %acc = alloca i32\n"
+  "  %i = alloca i32\n"
+  "  store i32 0, i32* %acc\n"
+  "  store i32 0, i32* %i\n"
+  "  br label %cond\n"
+  "cond:\n"
+  "  %iv = load i32* %i\n"
+  "  %c = icmp slt i32 %iv, %n\n"
+  "  br i1 %c, label %body, label %exit\n"
+  "body:\n"
+  "  %a = load i32* %acc\n"
+  "  %sq = call i32 @square(i32 %iv)\n"
+  "  %a2 = add i32 %a, %sq\n"
+  "  store i32 %a2, i32* %acc\n"
+  "  %iv2 = add i32 %iv, 1\n"
+  "  store i32 %iv2, i32* %i\n"
+  "  br label %cond\n"
+  "exit:\n"
+  "  %res = load i32* %acc\n"
+  "  ret i32 %res\n"
+  "}\n"
+  "define i32 @main() {\n"
+  "  %r = call i32 @sum(i32 10)\n"
+  "  ret i32 %r\n"
+  "}\n";
+
+struct PipelineJob {
+  bool Parsed;
+  bool Broken;
+  bool SquareRemains;
+  std::string Result;
+
+  PipelineJob() : Parsed(false), Broken(true), SquareRemains(true) {}
+};
+
+void *runO2Pipeline(void *Arg) {
+  PipelineJob &Job = *static_cast<PipelineJob *>(Arg);
+
+  LLVMContext Context;
+  SMDiagnostic Err;
+  Module *M = ParseAssemblyString(TestIR, 0, Err, Context);
+  Job.Parsed = M != 0;
+  if (!M)
+    return 0;
+
+  PassManagerBuilder Builder;
+  Builder.OptLevel = 2;
+  Builder.Inliner = createFunctionInliningPass(275);
+
+  FunctionPassManager FPM(M);
+  Builder.populateFunctionPassManager(FPM);
+  PassManager MPM;
+  Builder.populateModulePassManager(MPM);
+
+  FPM.doInitialization();
+  for (Module::iterator F = M->begin(), E = M->end(); F != E; ++F)
+    FPM.run(*F);
+  FPM.doFinalization();
+  MPM.run(*M);
+
+  Job.Broken = verifyModule(*M, ReturnStatusAction);
+  Job.SquareRemains = M->getFunction("square") != 0;
+  raw_string_ostream OS(Job.Result);
+  M->print(OS, 0);
+  OS.flush();
+
+  delete M;
+  return 0;
+}
+
+TEST(PassManagerThreadTest, ConcurrentO2Pipelines) {
+  const unsigned NumThreads = 32;
+
+  // Other tests share this binary, so leave the threading mode as we found it.
+  bool WasMultithreaded = llvm_is_multithreaded();
+  if (!WasMultithreaded)
+    llvm_start_multithreaded();
+  pthread_t Threads[NumThreads];
+  PipelineJob Jobs[NumThreads];
+  for (unsigned i = 0; i != NumThreads; ++i)
+    pthread_create(&Threads[i], NULL, runO2Pipeline, &Jobs[i]);
+  for (unsigned i = 0; i != NumThreads; ++i)
+    pthread_join(Threads[i], NULL);
+  if (!WasMultithreaded)
+    llvm_stop_multithreaded();
+
+  // Every pipeline must succeed, and since the threads share nothing but
+  // LLVM's global state, they must all produce exactly the same module.
+  for (unsigned i = 0; i != NumThreads; ++i) {
+    EXPECT_TRUE(Jobs[i].Parsed);
+    EXPECT_FALSE(Jobs[i].Broken);
+    EXPECT_FALSE(Jobs[i].SquareRemains);
+    EXPECT_EQ(Jobs[0].Result, Jobs[i].Result);
+  }
+}
+#endif
+
+} // anonymous namespace